@@ -40,40 +40,3570 @@
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <stdarg.h>
+#include <stdint.h>
 #include <string.h>
 #include <math.h>
+#include <time.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+#include <setjmp.h>
+#include <sys/time.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <sys/stat.h>
+#include <pthread.h>
+#include <sched.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <poll.h>
+#include <sys/mman.h>
+#define __MT_HAS_POSIX 1
+#else
+#define __MT_HAS_POSIX 0
+#endif
+
+/* 硬件性能计数器采集（在引用该头文件前定义MT_PERF_COUNTERS开启）基于perf_event_open，仅支持Linux */
+#if defined(MT_PERF_COUNTERS) && defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#define __MT_PERF 1
+/* glibc只在开启_DEFAULT_SOURCE等特性宏时才声明syscall，这里重复声明其原型，使本文件不依赖特性宏及引用顺序 */
+long syscall(long number, ...);
+#else
+#define __MT_PERF 0
+#endif
+
+/* 框架内部的辅助函数均定义为static，某些测试程序未使用到的接口不应触发编译告警 */
+/* 断言失败的处理函数标记为cold且不内联，使断言通过时的执行路径只有一次预测成功的比较 */
+#if defined(__GNUC__)
+#define __MT_UNUSED __attribute__((unused))
+#define __MT_COLD __attribute__((cold, noinline, unused))
+#define __MT_PRINTF(fmt_index, args_index) __attribute__((format(printf, fmt_index, args_index)))
+#define __MT_UNLIKELY(condition) __builtin_expect(!!(condition), 0)
+#else
+#define __MT_UNUSED
+#define __MT_COLD
+#define __MT_PRINTF(fmt_index, args_index)
+#define __MT_UNLIKELY(condition) (condition)
+#endif
+
+/* 断言状态为线程局部变量，编译器不支持线程局部存储时无法保证多线程断言的正确性，直接报错 */
+#if defined(__GNUC__)
+#define __MT_THREAD_LOCAL __thread
+#elif defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L
+#define __MT_THREAD_LOCAL _Thread_local
+#elif defined(_MSC_VER)
+#define __MT_THREAD_LOCAL __declspec(thread)
+#else
+#error "mintest requires thread-local storage (__thread or _Thread_local)"
+#endif
 
 /* 测试检查失败提示消息的最大长度，可通过在引用该头文件前定义对应宏来覆盖当前默认值 */
 #ifndef MT_MESSAGE_MAX_LEN
 #define MT_MESSAGE_MAX_LEN (512)
 #endif
 
+/* mt_expect_*非致命检查失败消息的内存区域大小（字节），以及单个用例最多保留的失败消息条数，超出部分只计数不保留 */
+#ifndef MT_EXPECT_ARENA_SIZE
+#define MT_EXPECT_ARENA_SIZE (64 * 1024)
+#endif
+#ifndef MT_EXPECT_MAX_FAILURES
+#define MT_EXPECT_MAX_FAILURES (32)
+#endif
+
 /* 浮点数比较精度，差值小于该精度的两个浮点数会被认为相等，支持自定义覆盖当前默认值 */
 #ifndef MT_FLOAT_EPSILON
 #define MT_FLOAT_EPSILON (1E-12)
 #endif
 
-/* 测试用例执行的相关统计和状态记录 */
-static int __mt_testcase_total_count = 0; /* 已执行的测试用例总数 */
-static int __mt_testcase_fail_count = 0;  /* 执行失败的测试用例数 */
-static int __mt_testcase_run_status = 0;  /* 临时记录当前测试用例执行状态（0:成功 / 1:失败） */
+/* 并行模式下同时运行的worker进程数上限，实际并行数由环境变量MT_JOBS或MT_CONFIGURE_JOBS指定 */
+#ifndef MT_MAX_JOBS
+#define MT_MAX_JOBS (64)
+#endif
+
+/* 基准测试的目标采样总时长、预热时长（毫秒）及采样次数，目标时长也可由环境变量MT_BENCH_TIME_MS覆盖， */
+/* 采样次数不少于100时基准测试结果中才会输出p99 */
+#ifndef MT_BENCH_TIME_MS
+#define MT_BENCH_TIME_MS (500)
+#endif
+#ifndef MT_BENCH_WARMUP_MS
+#define MT_BENCH_WARMUP_MS (50)
+#endif
+#ifndef MT_BENCH_SAMPLES
+#define MT_BENCH_SAMPLES (50)
+#endif
+
+/* 范围基准测试在每个数据规模下的采样次数、最多测量的规模个数，以及两次调用之间清除CPU缓存时遍历的缓冲区大小（字节） */
+#ifndef MT_BENCH_RANGE_SAMPLES
+#define MT_BENCH_RANGE_SAMPLES (5)
+#endif
+#ifndef MT_BENCH_RANGE_MAX_STEPS
+#define MT_BENCH_RANGE_MAX_STEPS (48)
+#endif
+#ifndef MT_BENCH_FLUSH_BYTES
+#define MT_BENCH_FLUSH_BYTES (32 * 1024 * 1024)
+#endif
+
+/* 复杂度拟合的容差：声明复杂度在对数空间中的均方根误差（约为相对误差）不超过最佳拟合误差加上该值时， */
+/* 仍视为符合声明，避免缓存层级变化等因素使O(n)与O(n log n)这类相近的曲线被误判 */
+#ifndef MT_BENCH_COMPLEXITY_TOLERANCE
+#define MT_BENCH_COMPLEXITY_TOLERANCE (0.1)
+#endif
+
+/* 基准测试与基线比较时的显著性水平及中位数最小相对变化，二者同时满足时才判定为变快或变慢 */
+#ifndef MT_BASELINE_ALPHA
+#define MT_BASELINE_ALPHA (0.01)
+#endif
+#ifndef MT_BASELINE_MIN_CHANGE
+#define MT_BASELINE_MIN_CHANGE (0.05)
+#endif
+
+/* 单个测试用例的默认超时时间（毫秒，0表示不限制），也可由环境变量MT_TIMEOUT_MS覆盖 */
+#ifndef MT_TESTCASE_TIMEOUT_MS
+#define MT_TESTCASE_TIMEOUT_MS (0)
+#endif
+
+/* 测试统计报告中列出的耗时最长的测试用例数 */
+#ifndef MT_SLOWEST_COUNT
+#define MT_SLOWEST_COUNT (5)
+#endif
+
+/* 批量内存/数组比较断言失败时，提示消息中展示的首个不一致位置前后的元素个数（字节比较时为字节数的1/2） */
+#ifndef MT_DIFF_WINDOW
+#define MT_DIFF_WINDOW (4)
+#endif
+
+/* 开启内存分配跟踪（在引用该头文件前定义MT_TRACK_ALLOCATIONS）时可同时跟踪的存活内存块数上限 */
+#ifndef MT_ALLOC_TRACK_SLOTS
+#define MT_ALLOC_TRACK_SLOTS (65536)
+#endif
+
+/* 可同时打开的机器可读报告器数量上限，以及每个报告文件的输出缓冲区大小（字节） */
+#ifndef MT_MAX_REPORTERS
+#define MT_MAX_REPORTERS (4)
+#endif
+#ifndef MT_REPORT_BUFFER_SIZE
+#define MT_REPORT_BUFFER_SIZE (1 << 20)
+#endif
+
+/* 开启运行过程追踪时环形缓冲区可保存的事件数上限，超出后最早的事件会被覆盖 */
+#ifndef MT_TRACE_EVENTS
+#define MT_TRACE_EVENTS (65536)
+#endif
+
+/* 模糊测试单个输入的最大长度（字节）、语料库中的输入数上限，以及每个模糊测试用例的默认时长（毫秒）和执行次数上限 */
+/* （0表示不限制），时长和次数也可由环境变量MT_FUZZ_TIME_MS和MT_FUZZ_RUNS覆盖 */
+#ifndef MT_FUZZ_MAX_LEN
+#define MT_FUZZ_MAX_LEN (4096)
+#endif
+#ifndef MT_FUZZ_CORPUS_MAX
+#define MT_FUZZ_CORPUS_MAX (4096)
+#endif
+#ifndef MT_FUZZ_TIME_MS
+#define MT_FUZZ_TIME_MS (200)
+#endif
+#ifndef MT_FUZZ_RUNS
+#define MT_FUZZ_RUNS (0)
+#endif
+
+/* 数据驱动用例中单条CSV记录的字段数上限，以及字段转换为数值时允许的最大字段长度（字节） */
+#ifndef MT_DATA_MAX_FIELDS
+#define MT_DATA_MAX_FIELDS (64)
+#endif
+#ifndef MT_DATA_MAX_NUMBER_LEN
+#define MT_DATA_MAX_NUMBER_LEN (63)
+#endif
+
+/* 测试用例执行的相关统计和状态记录，执行状态为线程局部变量，用例内的各个线程可以独立地执行断言 */
+static int __mt_testcase_total_count = 0;                  /* 已执行的测试用例总数 */
+static int __mt_testcase_fail_count = 0;                   /* 执行失败的测试用例数 */
+static __MT_THREAD_LOCAL int __mt_testcase_run_status = 0; /* 临时记录当前测试用例执行状态（0:成功 / 1:失败） */
+static int __mt_benchcase_total_count = 0;      /* 已执行的基准测试总数 */
+static int __mt_benchcase_fail_count = 0;       /* 执行过程中断言失败的基准测试数 */
+static int __mt_benchcase_regression_count = 0; /* 与基线相比显著变慢的基准测试数 */
 
 /* 测试用例的前置准备工作和清理工作接口函数指针，分别在测试逻辑执行前和执行后被调用 */
 /* 同一测试套件内的所有测试用例共用同一套准备和清理接口 */
 static void (*__mt_setup_testcase)(void) = NULL;
 static void (*__mt_teardown_testcase)(void) = NULL;
 
-/* 缓存测试过程assert检查失败时输出的消息用于后续格式化打印输出 */
-static char __mt_message_cache[MT_MESSAGE_MAX_LEN] = {0};
+/* 测试套件级别的共享夹具：setup_once在套件中第一个被选中的用例运行前执行一次并返回夹具上下文， */
+/* teardown_once在套件结束时以该上下文为参数执行一次，reset在每个用例开始前执行，用于低成本地恢复夹具状态 */
+/* 并行模式下夹具在父进程中创建，各worker进程通过fork继承（写时复制），对夹具的修改不会影响其它用例 */
+static void *(*__mt_setup_testsuite)(void) = NULL;
+static void (*__mt_teardown_testsuite)(void *context) = NULL;
+static void (*__mt_reset_testcase)(void *context) = NULL;
+static void *__mt_fixture_context = NULL;
+static int __mt_fixture_ready = 0;
+
+/* 测试用例函数体与夹具的累计墙钟耗时（纳秒），分别统计当前套件和全部套件 */
+static double __mt_testsuite_body_ns = 0;
+static double __mt_testsuite_fixture_ns = 0;
+static double __mt_testsuite_fixture_once_ns = 0;
+static double __mt_total_body_ns = 0;
+static double __mt_total_fixture_ns = 0;
+static double __mt_total_fixture_once_ns = 0;
+
+/* 缓存测试过程assert检查失败时输出的消息及断言所在的源文件和行号，用于后续格式化打印输出 */
+/* 与执行状态一样为线程局部变量，并发运行的用例中各线程的失败信息由MT_RUN_CONCURRENT合并回用例 */
+static __MT_THREAD_LOCAL char __mt_message_cache[MT_MESSAGE_MAX_LEN] = {0};
+static __MT_THREAD_LOCAL const char *__mt_failure_file = NULL;
+static __MT_THREAD_LOCAL int __mt_failure_line = 0;
+static __MT_THREAD_LOCAL int __mt_failure_fatal = 1; /* 当前失败是否来自mt_assert_*（由检查宏在失败时设置） */
+
+#if __MT_HAS_POSIX
+/* 用例函数体中自行创建的线程上的断言失败：失败状态是执行用例的线程的线程局部变量，其它线程的失败由首个失败的 */
+/* 线程通过原子操作写入以下共享槽位（0:空闲 / 1:写入中 / 2:已写入），函数体结束后再合并回用例的执行结果 */
+static pthread_t __mt_owner_thread;
+static volatile int __mt_shared_state = 0;
+static char __mt_shared_message[MT_MESSAGE_MAX_LEN];
+static const char *__mt_shared_file = NULL;
+static int __mt_shared_line = 0;
+#endif
+
+/* mt_expect_*失败记录：每条记录由记录头和紧随其后的完整消息组成，依次存放在每个线程独立的定长内存区域中， */
+/* 记录失败时无需动态分配内存，用例开始时将已用长度清零即可一次性释放全部记录 */
+struct __mt_expect_record
+{
+    const char *file;
+    int line;
+    int length; /* 消息长度（不含结尾的'\0'） */
+};
+static __MT_THREAD_LOCAL struct __mt_expect_record
+    __mt_expect_arena[MT_EXPECT_ARENA_SIZE / sizeof(struct __mt_expect_record)];
+static __MT_THREAD_LOCAL size_t __mt_expect_used = 0; /* 已用字节数，总是记录头大小的整数倍 */
+static __MT_THREAD_LOCAL int __mt_expect_kept = 0;    /* 已保留的失败记录数 */
+static __MT_THREAD_LOCAL int __mt_expect_count = 0;   /* 失败总数，包括超出上限未保留的失败 */
+
+/* 数据驱动用例当前记录的序号（不在数据驱动用例中时为-1）及CSV记录所在的行号（二进制记录为0），失败消息以此为前缀 */
+static __MT_THREAD_LOCAL long __mt_data_index = -1;
+static __MT_THREAD_LOCAL long __mt_data_line = 0;
+static __MT_THREAD_LOCAL int __mt_data_fatal = 0; /* 当前记录中是否出现过致命失败，出现后不再执行后续记录 */
+
+/* 并行执行相关配置：worker进程数（0:尚未初始化 / 1:串行执行），以及当前测试套件是否要求串行执行 */
+static int __mt_jobs = 0;
+static int __mt_testsuite_serial = 0;
+
+/* 单个测试用例执行期间的内存分配统计，仅在开启内存分配跟踪时有效 */
+struct __mt_alloc_stats
+{
+    size_t count;         /* 分配次数（malloc/calloc/realloc） */
+    size_t bytes;         /* 累计分配的字节数 */
+    size_t live_blocks;   /* 当前尚未释放的内存块数 */
+    size_t live_bytes;    /* 当前尚未释放的字节数 */
+    size_t peak_bytes;    /* 未释放字节数的峰值 */
+};
+
+/* 单个测试用例执行期间的性能计数器读数，仅在开启MT_PERF_COUNTERS时有效 */
+/* 硬件计数器可用时依次为指令数、缓存未命中数、分支预测失败数，不可用时（权限受限或虚拟机等）退化为 */
+/* 软件事件：任务时钟（纳秒）、缺页次数、上下文切换次数 */
+#define __MT_PERF_EVENTS (3)
+struct __mt_perf_counters
+{
+    int kind;    /* 0:不可用 / 1:硬件事件 / 2:软件事件 */
+    int skipped; /* 因硬件计数器不可用而未做检查的阈值断言数 */
+    uint64_t values[__MT_PERF_EVENTS];
+};
+
+/* 单个测试用例的执行结果，并行模式下由worker进程通过管道以该固定格式回传给父进程 */
+struct __mt_testcase_result
+{
+    int status;       /* 执行状态（0:成功 / 1:失败） */
+    double wall_ns;   /* 用例执行的墙钟耗时（纳秒） */
+    double cpu_ns;    /* 用例执行的CPU耗时（纳秒） */
+    double fixture_ns; /* 用例的reset、setup和teardown接口的墙钟耗时（纳秒），不计入wall_ns */
+    const char *file; /* 失败断言所在的源文件（指向__FILE__常量，父子进程中地址相同），非断言失败时为NULL */
+    int line;         /* 失败断言所在的行号 */
+    int failures;     /* 存在mt_expect_*失败时为用例的失败总数，各失败消息保存在expect内存区域中 */
+    size_t failures_size; /* expect内存区域中失败记录的字节数，并行模式下紧随结果之后回传 */
+    struct __mt_alloc_stats allocs; /* 用例执行期间的内存分配统计，用例结束时仍存活的内存块即为泄漏 */
+    struct __mt_perf_counters perf; /* 用例执行期间的性能计数器读数 */
+    char message[MT_MESSAGE_MAX_LEN];
+};
+
+/* 已执行用例中耗时最长的MT_SLOWEST_COUNT个用例，按墙钟耗时降序排列 */
+struct __mt_slowest_testcase
+{
+    const char *name;
+    double wall_ns;
+    double cpu_ns;
+};
+static __MT_UNUSED struct __mt_slowest_testcase __mt_slowest_testcases[MT_SLOWEST_COUNT];
+static int __mt_slowest_count = 0;
+
+#if __MT_HAS_POSIX
+/* 正在运行的worker进程队列（环形队列），父进程按提交顺序回收结果以保证输出顺序稳定 */
+struct __mt_worker
+{
+    pid_t pid;
+    int fd;
+    int lane; /* 追踪事件中的进程通道编号，在同时运行的worker之间唯一 */
+    const char *name;
+    long timeout_ms;  /* 用例的超时时间（毫秒），0表示不限制，由父进程负责计时并结束超时的worker */
+    double start_ns;  /* worker的启动时刻 */
+    int kind;         /* 0:测试用例 / 1:模糊测试用例，结果之后传回模糊测试的统计信息 / 2:并发测试用例，结果之后传回各线程统计 */
+};
+static struct __mt_worker __mt_workers[MT_MAX_JOBS];
+static int __mt_worker_head = 0;
+static int __mt_worker_count = 0;
+#endif
+
+/* 测试用例和测试套件的注册表项，定义用例/套件时以静态变量形式构造并在程序启动时串联成链表 */
+/* 注册过程不进行任何内存分配，注册表供mt_main运行全部用例以及列举、过滤用例时使用 */
+struct __mt_registry_entry
+{
+    const char *name;
+    void (*function)(void);
+    const char *file; /* 定义所在的源文件，用于判断用例自上次运行后是否有改动 */
+    int referenced;   /* 用例是否已被某个测试套件通过MT_RUN_TESTCASE引用 */
+    struct __mt_registry_entry *next;
+};
+static __MT_UNUSED struct __mt_registry_entry *__mt_testcase_registry = NULL;
+static __MT_UNUSED struct __mt_registry_entry **__mt_testcase_registry_tail = &__mt_testcase_registry;
+static __MT_UNUSED struct __mt_registry_entry *__mt_testsuite_registry = NULL;
+static __MT_UNUSED struct __mt_registry_entry **__mt_testsuite_registry_tail = &__mt_testsuite_registry;
+
+/* 按定义顺序将注册表项追加到链表末尾 */
+static __MT_UNUSED void __mt_registry_append(struct __mt_registry_entry ***tail, struct __mt_registry_entry *entry)
+{
+    **tail = entry;
+    *tail = &entry->next;
+}
+
+/* 在main函数执行前自动调用的注册函数，不支持constructor属性的编译器下自动注册不可用 */
+#if defined(__GNUC__)
+#define __MT_CONSTRUCTOR(fn_name)                           \
+    static void fn_name(void) __attribute__((constructor)); \
+    static void fn_name(void)
+#else
+#define __MT_CONSTRUCTOR(fn_name) \
+    static __MT_UNUSED void fn_name(void)
+#endif
 
 /* 用于定义测试用例和测试套件，基于输入的用例/套件名构造测试框架内部使用的测试接口函数 */
-#define MT_TESTCASE(case_name) \
+/* 定义的同时会自动注册到对应的注册表中，供mt_main自动运行 */
+#define MT_TESTCASE(case_name)                                                                \
+    static void __mt_testcase_##case_name(void);                                              \
+    static struct __mt_registry_entry __mt_testcase_entry_##case_name =                       \
+        {#case_name, &__mt_testcase_##case_name, __FILE__, 0, NULL};                          \
+    __MT_CONSTRUCTOR(__mt_register_testcase_##case_name)                                      \
+    {                                                                                         \
+        __mt_registry_append(&__mt_testcase_registry_tail, &__mt_testcase_entry_##case_name); \
+    }                                                                                         \
     static void __mt_testcase_##case_name(void)
-#define MT_TESTSUITE(suite_name) \
+#define MT_TESTSUITE(suite_name)                                                                 \
+    static void __mt_testsuite_##suite_name(void);                                               \
+    static struct __mt_registry_entry __mt_testsuite_entry_##suite_name =                        \
+        {#suite_name, &__mt_testsuite_##suite_name, __FILE__, 0, NULL};                          \
+    __MT_CONSTRUCTOR(__mt_register_testsuite_##suite_name)                                       \
+    {                                                                                            \
+        __mt_registry_append(&__mt_testsuite_registry_tail, &__mt_testsuite_entry_##suite_name); \
+    }                                                                                            \
     static void __mt_testsuite_##suite_name(void)
 
+/* 用于定义使用共享夹具的测试用例，用例函数体内可通过fixture_name访问类型为type *的夹具上下文 */
+#define MT_TESTCASE_F(case_name, type, fixture_name)               \
+    static void __mt_testcase_f_##case_name(type *fixture_name);   \
+    MT_TESTCASE(case_name)                                         \
+    {                                                              \
+        __mt_testcase_f_##case_name((type *)__mt_fixture_context); \
+    }                                                              \
+    static void __mt_testcase_f_##case_name(type *fixture_name)
+
+/* 用例选择相关状态：当前运行的测试套件名及其输出是否已开始、用例名过滤规则、分片配置以及是否仅列举用例 */
+static const char *__mt_current_testsuite = NULL;
+static int __mt_testsuite_started = 0;
+static const char *__mt_filter = NULL;
+static int __mt_shard_index = 0;
+static int __mt_shard_total = 0; /* 0表示尚未从环境变量读取分片配置 */
+static int __mt_shard_ordinal = 0;
+static int __mt_testsuite_shard_ordinal = -1; /* 串行测试套件整体分配到同一个分片 */
+static int __mt_list_only = 0;
+
+/* 获取单调递增的当前时间（纳秒），用于基准测试及用例耗时统计 */
+static __MT_UNUSED double __mt_now_ns(void)
+{
+#if __MT_HAS_POSIX
+    struct timespec ts;
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1E9 + (double)ts.tv_nsec;
+#else
+    return (double)clock() * (1E9 / CLOCKS_PER_SEC);
+#endif
+}
+
+/* 获取当前进程已消耗的CPU时间（纳秒） */
+static __MT_UNUSED double __mt_cpu_now_ns(void)
+{
+#if __MT_HAS_POSIX
+    struct timespec ts;
+    (void)clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return (double)ts.tv_sec * 1E9 + (double)ts.tv_nsec;
+#else
+    return (double)clock() * (1E9 / CLOCKS_PER_SEC);
+#endif
+}
+
+/* 运行过程追踪：通过--trace=FILE（或环境变量MT_TRACE）开启后，测试套件、用例、夹具、报告输出及MT_TRACE_SCOPE */
+/* 标记的代码片段的起止时间被记录到预先分配的环形缓冲区中（写满后覆盖最早的事件），程序退出时以Chrome/Perfetto */
+/* 的trace event JSON格式写入文件；并行模式下worker进程的事件随用例结果传回父进程，每个worker显示为独立的进程通道 */
+struct __mt_trace_event
+{
+    const char *name;     /* 事件名（指向字符串常量，父子进程中地址相同） */
+    const char *category; /* 事件分类：suite、testcase、fixture、report、bench、thread或user */
+    double begin_ns;      /* 开始时间（CLOCK_MONOTONIC，各进程共用同一时间基准） */
+    double end_ns;        /* 结束时间 */
+    int lane;             /* 进程通道：0为主进程，worker进程从1开始编号 */
+    int thread;           /* 线程序号：0为执行用例的线程，MT_RUN_CONCURRENT启动的线程从1开始编号 */
+};
+static struct __mt_trace_event *__mt_trace_events = NULL;
+static const char *__mt_trace_path = NULL;
+static int __mt_trace_state = 0; /* 0:尚未初始化 / 1:开启 / -1:关闭 */
+static volatile unsigned long __mt_trace_count = 0;
+static int __mt_trace_lane = 0;
+static int __mt_trace_max_lane = 0;
+static __MT_THREAD_LOCAL int __mt_trace_thread = 0;
+static void __mt_trace_write(void);
+
+/* 判断追踪是否开启，首次调用时按配置分配环形缓冲区并注册退出时写出追踪文件 */
+static __MT_UNUSED int __mt_trace_enabled(void)
+{
+    if (__MT_UNLIKELY(0 == __mt_trace_state))
+    {
+        __mt_trace_state = -1;
+        if (NULL == __mt_trace_path)
+        {
+            __mt_trace_path = getenv("MT_TRACE");
+        }
+        if (__mt_trace_path && *__mt_trace_path)
+        {
+            __mt_trace_events = (struct __mt_trace_event *)malloc(MT_TRACE_EVENTS * sizeof(struct __mt_trace_event));
+            if (__mt_trace_events && 0 == atexit(__mt_trace_write))
+            {
+                __mt_trace_state = 1;
+            }
+        }
+    }
+    return 1 == __mt_trace_state;
+}
+
+/* 追踪开启时返回事件的开始时间，否则返回0，与__mt_trace_record配合使用 */
+static __MT_UNUSED double __mt_trace_begin(void)
+{
+    return __mt_trace_enabled() ? __mt_now_ns() : 0;
+}
+
+/* 以当前时间为结束时间记录一个事件，begin_ns为0（追踪未开启）时忽略，可在多个线程中同时调用 */
+static __MT_UNUSED void __mt_trace_record(const char *category, const char *name, double begin_ns)
+{
+    struct __mt_trace_event *event = NULL;
+
+    if (begin_ns <= 0)
+    {
+        return;
+    }
+    event = &__mt_trace_events[__sync_fetch_and_add(&__mt_trace_count, 1) % MT_TRACE_EVENTS];
+    event->name = name;
+    event->category = category;
+    event->begin_ns = begin_ns;
+    event->end_ns = __mt_now_ns();
+    event->lane = __mt_trace_lane;
+    event->thread = __mt_trace_thread;
+}
+
+/* 在测试代码中标记一段追踪区间，区间从宏所在位置开始，到所在代码块结束时自动结束，name需为字符串常量 */
+#if defined(__GNUC__)
+struct __mt_trace_scope
+{
+    const char *name;
+    double begin_ns;
+};
+static __MT_UNUSED void __mt_trace_scope_end(struct __mt_trace_scope *scope)
+{
+    __mt_trace_record("user", scope->name, scope->begin_ns);
+}
+#define __MT_TRACE_SCOPE_VAR(line) __MT_TRACE_SCOPE_VAR_(line)
+#define __MT_TRACE_SCOPE_VAR_(line) __mt_trace_scope_##line
+#define MT_TRACE_SCOPE(name)                               \
+    struct __mt_trace_scope __MT_TRACE_SCOPE_VAR(__LINE__) \
+        __attribute__((cleanup(__mt_trace_scope_end))) = {(name), __mt_trace_begin()}
+#else
+#define MT_TRACE_SCOPE(name) (void)(name)
+#endif
+
+#ifdef MT_TRACK_ALLOCATIONS
+/* 内存分配跟踪：通过包装malloc/calloc/realloc/free统计用例逻辑执行期间的内存分配情况 */
+/* 默认在本文件末尾以同名宏替换当前编译单元中的分配函数调用；定义MT_TRACK_ALLOCATIONS_WRAP时改为 */
+/* 提供__wrap_malloc等函数，配合链接参数-Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc,--wrap=free */
+/* 即可同时跟踪其它编译单元（被测代码）中的内存分配；__wrap_*是外部函数定义，因此只能在恰好一个编译单元中 */
+/* 定义MT_TRACK_ALLOCATIONS_WRAP后引用本文件，否则链接时会出现重复定义 */
+#ifdef MT_TRACK_ALLOCATIONS_WRAP
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t count, size_t size);
+void *__real_realloc(void *pointer, size_t size);
+void __real_free(void *pointer);
+#define __MT_REAL_MALLOC __real_malloc
+#define __MT_REAL_CALLOC __real_calloc
+#define __MT_REAL_REALLOC __real_realloc
+#define __MT_REAL_FREE __real_free
+#else
+#define __MT_REAL_MALLOC malloc
+#define __MT_REAL_CALLOC calloc
+#define __MT_REAL_REALLOC realloc
+#define __MT_REAL_FREE free
+#endif
+
+/* 存活内存块表（线性探测的开放寻址哈希表），仅记录跟踪期间分配的内存块，其它内存块的释放会被忽略 */
+struct __mt_alloc_slot
+{
+    uintptr_t address; /* 内存块地址，0表示空位 */
+    size_t size;
+};
+static struct __mt_alloc_slot __mt_alloc_slots[MT_ALLOC_TRACK_SLOTS];
+static struct __mt_alloc_stats __mt_alloc_stats;
+static int __mt_alloc_tracking = 0;
+
+/* 存活内存块表的自旋锁，保证用例内多个线程同时分配和释放内存时统计仍然准确 */
+#if defined(__GNUC__)
+static volatile int __mt_alloc_spinlock = 0;
+#define __MT_ALLOC_LOCK()                                         \
+    do                                                            \
+    {                                                             \
+        while (__sync_lock_test_and_set(&__mt_alloc_spinlock, 1)) \
+        {                                                         \
+        }                                                         \
+    } while (0)
+#define __MT_ALLOC_UNLOCK() __sync_lock_release(&__mt_alloc_spinlock)
+#else
+#define __MT_ALLOC_LOCK()
+#define __MT_ALLOC_UNLOCK()
+#endif
+
+static size_t __mt_alloc_hash(uintptr_t address)
+{
+    return (size_t)((address >> 4) * 2654435761u) % MT_ALLOC_TRACK_SLOTS;
+}
+
+/* 记录新分配的内存块，存活内存块表已满时仅计入分配统计 */
+static void __mt_alloc_record(uintptr_t address, size_t size)
+{
+    size_t i = __mt_alloc_hash(address), n = 0;
+
+    __mt_alloc_stats.count++;
+    __mt_alloc_stats.bytes += size;
+    for (n = 0; n < MT_ALLOC_TRACK_SLOTS; n++, i = (i + 1) % MT_ALLOC_TRACK_SLOTS)
+    {
+        if (0 == __mt_alloc_slots[i].address)
+        {
+            __mt_alloc_slots[i].address = address;
+            __mt_alloc_slots[i].size = size;
+            __mt_alloc_stats.live_blocks++;
+            __mt_alloc_stats.live_bytes += size;
+            if (__mt_alloc_stats.live_bytes > __mt_alloc_stats.peak_bytes)
+            {
+                __mt_alloc_stats.peak_bytes = __mt_alloc_stats.live_bytes;
+            }
+            return;
+        }
+    }
+}
+
+/* 移除被释放的内存块，后续元素回填空位以保持线性探测链完整，返回被移除内存块的大小（未跟踪时为0） */
+static size_t __mt_alloc_forget(uintptr_t address)
+{
+    size_t i = __mt_alloc_hash(address), j = 0, k = 0, n = 0, size = 0;
+
+    for (n = 0; n < MT_ALLOC_TRACK_SLOTS && __mt_alloc_slots[i].address != address; n++)
+    {
+        if (0 == __mt_alloc_slots[i].address)
+        {
+            return 0;
+        }
+        i = (i + 1) % MT_ALLOC_TRACK_SLOTS;
+    }
+    if (n == MT_ALLOC_TRACK_SLOTS)
+    {
+        return 0;
+    }
+    size = __mt_alloc_slots[i].size;
+    __mt_alloc_stats.live_blocks--;
+    __mt_alloc_stats.live_bytes -= size;
+    __mt_alloc_slots[i].address = 0;
+    for (j = (i + 1) % MT_ALLOC_TRACK_SLOTS; __mt_alloc_slots[j].address; j = (j + 1) % MT_ALLOC_TRACK_SLOTS)
+    {
+        k = __mt_alloc_hash(__mt_alloc_slots[j].address);
+        if ((j > i && (k <= i || k > j)) || (j < i && k <= i && k > j))
+        {
+            __mt_alloc_slots[i] = __mt_alloc_slots[j];
+            __mt_alloc_slots[j].address = 0;
+            i = j;
+        }
+    }
+    return size;
+}
+
+static __MT_UNUSED void *__mt_malloc(size_t size)
+{
+    void *pointer = __MT_REAL_MALLOC(size);
+    if (__mt_alloc_tracking && pointer)
+    {
+        __MT_ALLOC_LOCK();
+        __mt_alloc_record((uintptr_t)pointer, size);
+        __MT_ALLOC_UNLOCK();
+    }
+    return pointer;
+}
+static __MT_UNUSED void *__mt_calloc(size_t count, size_t size)
+{
+    void *pointer = __MT_REAL_CALLOC(count, size);
+    if (__mt_alloc_tracking && pointer)
+    {
+        __MT_ALLOC_LOCK();
+        __mt_alloc_record((uintptr_t)pointer, count * size);
+        __MT_ALLOC_UNLOCK();
+    }
+    return pointer;
+}
+static __MT_UNUSED void *__mt_realloc(void *pointer, size_t size)
+{
+    uintptr_t address = (uintptr_t)pointer;
+    size_t old_size = 0;
+    void *new_pointer = NULL;
+    if (!__mt_alloc_tracking)
+    {
+        return __MT_REAL_REALLOC(pointer, size);
+    }
+    /* 持锁先移除原内存块的记录再重新分配，避免原内存块被释放后立即被其它线程分配到并记录 */
+    __MT_ALLOC_LOCK();
+    old_size = address ? __mt_alloc_forget(address) : 0;
+    new_pointer = __MT_REAL_REALLOC(pointer, size);
+    if (new_pointer)
+    {
+        __mt_alloc_record((uintptr_t)new_pointer, size);
+    }
+    else if (old_size > 0 && 0 != size)
+    {
+        /* 重新分配失败时原内存块仍然有效，恢复其记录但不计入分配统计；size为0时返回NULL表示原内存块已被释放 */
+        __mt_alloc_record(address, old_size);
+        __mt_alloc_stats.count--;
+        __mt_alloc_stats.bytes -= old_size;
+    }
+    __MT_ALLOC_UNLOCK();
+    return new_pointer;
+}
+static __MT_UNUSED void __mt_free(void *pointer)
+{
+    if (__mt_alloc_tracking && pointer)
+    {
+        __MT_ALLOC_LOCK();
+        __mt_alloc_forget((uintptr_t)pointer);
+        __MT_ALLOC_UNLOCK();
+    }
+    __MT_REAL_FREE(pointer);
+}
+
+#ifdef MT_TRACK_ALLOCATIONS_WRAP
+void *__wrap_malloc(size_t size)
+{
+    return __mt_malloc(size);
+}
+void *__wrap_calloc(size_t count, size_t size)
+{
+    return __mt_calloc(count, size);
+}
+void *__wrap_realloc(void *pointer, size_t size)
+{
+    return __mt_realloc(pointer, size);
+}
+void __wrap_free(void *pointer)
+{
+    __mt_free(pointer);
+}
+#endif
+
+/* 开始跟踪当前用例的内存分配，上一个用例存在泄漏时清空其遗留的存活内存块记录 */
+static void __mt_alloc_begin(void)
+{
+    if (__mt_alloc_stats.live_blocks > 0)
+    {
+        memset(__mt_alloc_slots, 0, sizeof(__mt_alloc_slots));
+    }
+    memset(&__mt_alloc_stats, 0, sizeof(__mt_alloc_stats));
+    __mt_alloc_tracking = 1;
+}
+static void __mt_alloc_end(struct __mt_alloc_stats *stats)
+{
+    __mt_alloc_tracking = 0;
+    *stats = __mt_alloc_stats;
+}
+#endif
+
+#if __MT_PERF
+/* 性能计数器分组：组内第一个事件为组长，整组计数器同时开启和停止，一次read即可读取全部读数 */
+/* 计数器在首次使用时打开，并行模式下fork出的worker进程需重新打开以统计自身的执行情况 */
+static const char *__mt_perf_names[2][__MT_PERF_EVENTS] = {
+    {"instructions", "cache-misses", "branch-misses"},
+    {"task-clock ns", "page-faults", "context-switches"},
+};
+static int __mt_perf_fds[__MT_PERF_EVENTS] = {-1, -1, -1};
+static int __mt_perf_kind = 0;
+static pid_t __mt_perf_pid = 0;
+static int __mt_perf_skipped = 0;       /* 当前用例中未做检查的阈值断言数 */
+static int __mt_perf_skipped_total = 0; /* 所有用例中未做检查的阈值断言总数，由MT_REPORT_COUNT输出 */
+
+/* 打开一组计数器，user_only非0时只统计用户态，任一事件打开失败时关闭整组并返回非0 */
+static int __mt_perf_open_group(uint32_t type, const uint64_t configs[__MT_PERF_EVENTS], int user_only)
+{
+    struct perf_event_attr attr;
+    int i = 0;
+
+    for (i = 0; i < __MT_PERF_EVENTS; i++)
+    {
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = configs[i];
+        attr.disabled = (0 == i);
+        attr.exclude_kernel = (unsigned)user_only;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        __mt_perf_fds[i] = (int)syscall(SYS_perf_event_open, &attr, 0, -1, i ? __mt_perf_fds[0] : -1, 0);
+        if (__mt_perf_fds[i] < 0)
+        {
+            while (i-- > 0)
+            {
+                (void)close(__mt_perf_fds[i]);
+                __mt_perf_fds[i] = -1;
+            }
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/* 关闭当前打开的计数器分组，首次打开计数器时注册为进程退出时执行 */
+static void __mt_perf_close(void)
+{
+    int i = 0;
+
+    for (i = 0; i < __MT_PERF_EVENTS; i++)
+    {
+        if (__mt_perf_fds[i] >= 0)
+        {
+            (void)close(__mt_perf_fds[i]);
+            __mt_perf_fds[i] = -1;
+        }
+    }
+    __mt_perf_kind = 0;
+}
+
+/* 打开当前进程的计数器分组，优先使用（仅统计用户态的）硬件事件，不可用时静默退化为软件事件； */
+/* 上下文切换等软件事件发生在内核态，因此软件事件不排除内核态，权限不足时再退回到只统计用户态 */
+static void __mt_perf_open(void)
+{
+    static const uint64_t hardware[__MT_PERF_EVENTS] = {
+        PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+    static const uint64_t software[__MT_PERF_EVENTS] = {
+        PERF_COUNT_SW_TASK_CLOCK, PERF_COUNT_SW_PAGE_FAULTS, PERF_COUNT_SW_CONTEXT_SWITCHES};
+
+    if (__mt_perf_pid == getpid())
+    {
+        return;
+    }
+    if (0 == __mt_perf_pid)
+    {
+        (void)atexit(__mt_perf_close);
+    }
+    __mt_perf_close();
+    __mt_perf_pid = getpid();
+    if (0 == __mt_perf_open_group(PERF_TYPE_HARDWARE, hardware, 1))
+    {
+        __mt_perf_kind = 1;
+    }
+    else if (0 == __mt_perf_open_group(PERF_TYPE_SOFTWARE, software, 0) ||
+             0 == __mt_perf_open_group(PERF_TYPE_SOFTWARE, software, 1))
+    {
+        __mt_perf_kind = 2;
+    }
+}
+
+/* 读取计数器当前读数，计数器因复用未全程运行时按运行时间比例换算 */
+static void __mt_perf_read(struct __mt_perf_counters *counters)
+{
+    uint64_t data[3 + __MT_PERF_EVENTS];
+    int i = 0;
+
+    memset(counters, 0, sizeof(*counters));
+    if (0 == __mt_perf_kind ||
+        read(__mt_perf_fds[0], data, sizeof(data)) != (ssize_t)sizeof(data) ||
+        __MT_PERF_EVENTS != data[0])
+    {
+        return;
+    }
+    counters->kind = __mt_perf_kind;
+    for (i = 0; i < __MT_PERF_EVENTS; i++)
+    {
+        counters->values[i] = data[3 + i];
+        if (data[2] > 0 && data[2] < data[1])
+        {
+            counters->values[i] = (uint64_t)((double)data[3 + i] * (double)data[1] / (double)data[2]);
+        }
+    }
+}
+
+static void __mt_perf_start(void)
+{
+    __mt_perf_skipped = 0;
+    __mt_perf_open();
+    if (__mt_perf_kind)
+    {
+        (void)ioctl(__mt_perf_fds[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        (void)ioctl(__mt_perf_fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+}
+static void __mt_perf_stop(struct __mt_perf_counters *counters)
+{
+    if (__mt_perf_kind)
+    {
+        (void)ioctl(__mt_perf_fds[0], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+    }
+    __mt_perf_read(counters);
+    counters->skipped = __mt_perf_skipped;
+}
+
+/* 打印计数器读数，divisor用于换算为单次操作的平均值（基准测试） */
+static void __mt_perf_print(const struct __mt_perf_counters *counters, double divisor, const char *suffix)
+{
+    int i = 0;
+    for (i = 0; counters->kind && i < __MT_PERF_EVENTS; i++)
+    {
+        printf(", %.4g %s%s", (double)counters->values[i] / divisor, __mt_perf_names[counters->kind - 1][i], suffix);
+    }
+}
+#endif
+
+/* 打印失败提示消息，由断言产生的失败消息前附加断言所在的源文件和行号 */
+static __MT_UNUSED void __mt_print_failure(const char *file, int line, const char *message)
+{
+    if (file)
+    {
+        printf("    %s:%d: %s\n", file, line, message);
+    }
+    else
+    {
+        printf("    %s\n", message);
+    }
+}
+
+/* 清空当前线程的expect内存区域，在每个用例开始前调用 */
+static __MT_UNUSED void __mt_expect_reset(void)
+{
+    __mt_expect_used = 0;
+    __mt_expect_kept = 0;
+    __mt_expect_count = 0;
+}
+
+/* 在数据驱动用例中将当前记录的序号（CSV记录还包括行号）写入buffer作为失败消息的前缀，返回写入的长度 */
+static __MT_UNUSED int __mt_data_prefix(char *buffer, size_t size)
+{
+    int length = 0;
+
+    if (__mt_data_index < 0 || 0 == size)
+    {
+        return 0;
+    }
+    if (__mt_data_line > 0)
+    {
+        length = snprintf(buffer, size, "record %ld (line %ld): ", __mt_data_index, __mt_data_line);
+    }
+    else
+    {
+        length = snprintf(buffer, size, "record %ld: ", __mt_data_index);
+    }
+    return length < 0 ? 0 : ((size_t)length < size ? length : (int)size - 1);
+}
+
+/* 在expect内存区域末尾追加一条失败记录，条数达到上限或区域已满时只计数，区域剩余空间不足时截断消息 */
+static __MT_COLD void __mt_expect_append(const char *file, int line, const char *format, va_list args)
+{
+    const size_t unit = sizeof(struct __mt_expect_record);
+    size_t room = sizeof(__mt_expect_arena) - __mt_expect_used;
+    struct __mt_expect_record *record = NULL;
+    int length = 0, written = 0;
+
+    __mt_expect_count++;
+    if (__mt_expect_kept >= MT_EXPECT_MAX_FAILURES || room <= unit)
+    {
+        return;
+    }
+    record = __mt_expect_arena + __mt_expect_used / unit;
+    length = __mt_data_prefix((char *)(record + 1), room - unit);
+    written = vsnprintf((char *)(record + 1) + length, room - unit - (size_t)length, format, args);
+    length += written < 0 ? 0 : written;
+    length = (size_t)length < room - unit ? length : (int)(room - unit - 1);
+    record->file = file;
+    record->line = line;
+    record->length = length;
+    __mt_expect_used += (unit + (size_t)length + unit) / unit * unit;
+    __mt_expect_kept++;
+}
+
+/* 记录断言失败：标记当前用例失败，并按格式生成提示消息，源文件和行号单独记录 */
+/* 用例中第一个失败的消息总是记录在消息缓存中；出现过mt_expect_*失败后，此后的所有失败（包括mt_assert_*）都追加到 */
+/* expect内存区域，由用例结束时一并输出 */
+static __MT_COLD __MT_PRINTF(3, 4) void __mt_fail(const char *file, int line, const char *format, ...)
+{
+    va_list args;
+    int prefix = 0;
+    if (0 == __mt_expect_count)
+    {
+        prefix = __mt_data_prefix(__mt_message_cache, MT_MESSAGE_MAX_LEN);
+        va_start(args, format);
+        (void)vsnprintf(__mt_message_cache + prefix, MT_MESSAGE_MAX_LEN - prefix, format, args);
+        va_end(args);
+        __mt_failure_file = file;
+        __mt_failure_line = line;
+    }
+    if (!__mt_failure_fatal || __mt_expect_count > 0)
+    {
+        va_start(args, format);
+        __mt_expect_append(file, line, format, args);
+        va_end(args);
+    }
+    __mt_data_fatal |= __mt_failure_fatal;
+    __mt_failure_fatal = 1;
+    __mt_testcase_run_status = 1;
+#if __MT_HAS_POSIX
+    if (!pthread_equal(pthread_self(), __mt_owner_thread) && __sync_bool_compare_and_swap(&__mt_shared_state, 0, 1))
+    {
+        va_start(args, format);
+        (void)vsnprintf(__mt_shared_message, MT_MESSAGE_MAX_LEN, format, args);
+        va_end(args);
+        __mt_shared_file = file;
+        __mt_shared_line = line;
+        __sync_synchronize();
+        __mt_shared_state = 2;
+    }
+#endif
+}
+
+/* 用例函数体开始执行前记录执行用例的线程，并清空共享失败槽位 */
+static __MT_UNUSED void __mt_shared_begin(void)
+{
+#if __MT_HAS_POSIX
+    __mt_owner_thread = pthread_self();
+    __mt_shared_state = 0;
+    __sync_synchronize();
+#endif
+}
+
+/* 用例函数体结束后将其它线程的断言失败合并回用例，执行用例的线程自身已失败时保留其自身的失败信息 */
+static __MT_UNUSED void __mt_shared_merge(void)
+{
+#if __MT_HAS_POSIX
+    __sync_synchronize();
+    if (2 == __mt_shared_state && !__mt_testcase_run_status)
+    {
+        memcpy(__mt_message_cache, __mt_shared_message, MT_MESSAGE_MAX_LEN);
+        __mt_failure_file = __mt_shared_file;
+        __mt_failure_line = __mt_shared_line;
+        __mt_testcase_run_status = 1;
+    }
+#endif
+}
+
+/* 打印expect内存区域中的全部失败记录，以及超出保留上限而未保留的失败数 */
+/* 依次取出expect内存区域中用例的失败记录，offset为遍历位置（从0开始），取完后返回NULL； */
+/* 记录的消息紧随记录头之后并以'\0'结尾 */
+static __MT_UNUSED const struct __mt_expect_record *__mt_expect_next(const struct __mt_testcase_result *result,
+                                                                     size_t *offset)
+{
+    const size_t unit = sizeof(struct __mt_expect_record);
+    const struct __mt_expect_record *record = NULL;
+
+    if (*offset + unit > result->failures_size)
+    {
+        return NULL;
+    }
+    record = __mt_expect_arena + *offset / unit;
+    *offset += (unit + (size_t)record->length + unit) / unit * unit;
+    return record;
+}
+
+static __MT_UNUSED void __mt_print_expect_failures(const struct __mt_testcase_result *result)
+{
+    const struct __mt_expect_record *record = NULL;
+    size_t offset = 0;
+    int kept = 0;
+
+    while (NULL != (record = __mt_expect_next(result, &offset)))
+    {
+        __mt_print_failure(record->file, record->line, (const char *)(record + 1));
+        kept++;
+    }
+    if (result->failures > kept)
+    {
+        printf("    ... %d more failures not kept (MT_EXPECT_MAX_FAILURES %d, MT_EXPECT_ARENA_SIZE %d)\n",
+               result->failures - kept, MT_EXPECT_MAX_FAILURES, MT_EXPECT_ARENA_SIZE);
+    }
+}
+
+/* 机器可读的测试结果报告器：通过--report=KIND:FILE（或环境变量MT_REPORT）将每个用例的结果额外写入文件， */
+/* KIND可选tap、junit或jsonl，控制台输出格式保持不变；报告文件使用MT_REPORT_BUFFER_SIZE大小的缓冲区按块写出， */
+/* 用例结果中的耗时、失败消息及断言所在的源文件和行号均作为独立字段输出 */
+struct __mt_report_output;
+struct __mt_reporter
+{
+    const char *kind;
+    void (*begin)(struct __mt_report_output *output);
+    void (*testcase)(struct __mt_report_output *output, const char *suite, const char *name,
+                     const struct __mt_testcase_result *result);
+    void (*suite)(struct __mt_report_output *output); /* 测试套件结束时调用，可为NULL */
+    void (*end)(struct __mt_report_output *output);
+};
+struct __mt_report_output
+{
+    const struct __mt_reporter *reporter;
+    FILE *stream;
+    char *buffer;
+    const char *suite; /* 最近一个用例所属的测试套件名，JUnit报告据此划分<testsuite>元素 */
+    int count;         /* 已写出的用例数 */
+    FILE *pending;     /* JUnit报告中暂存当前测试套件内用例的临时文件，套件结束时统计出用例数后再写出 */
+    int suite_tests;   /* 当前测试套件内已写出的用例数 */
+    int suite_failures;
+};
+static struct __mt_report_output __mt_report_outputs[MT_MAX_REPORTERS];
+static int __mt_report_output_count = 0;
+static int __mt_report_initialized = 0;
+
+/* 按XML（json为0）或JSON（json为1）字符串规则转义输出文本，控制字符在XML中替换为空格 */
+static __MT_UNUSED void __mt_report_escape(FILE *stream, const char *text, int json)
+{
+    for (; text && *text; text++)
+    {
+        unsigned char c = (unsigned char)*text;
+        if (json && ('"' == c || '\\' == c))
+        {
+            fprintf(stream, "\\%c", c);
+        }
+        else if (json && c < 0x20)
+        {
+            fprintf(stream, "\\u%04x", c);
+        }
+        else if (!json && ('&' == c || '<' == c || '>' == c || '"' == c))
+        {
+            fputs('&' == c ? "&amp;" : '<' == c ? "&lt;" : '>' == c ? "&gt;" : "&quot;", stream);
+        }
+        else
+        {
+            fputc(!json && c < 0x20 && '\n' != c && '\t' != c ? ' ' : c, stream);
+        }
+    }
+}
+
+/* 程序退出时将环形缓冲区中保存的事件以Chrome trace event格式（完整事件，时间单位为微秒）写入追踪文件 */
+static void __mt_trace_write(void)
+{
+    unsigned long count = __mt_trace_count;
+    unsigned long first = count > MT_TRACE_EVENTS ? count - MT_TRACE_EVENTS : 0, i = 0;
+    double origin = 0;
+    FILE *file = fopen(__mt_trace_path, "w");
+    int lane = 0;
+
+    if (NULL == file)
+    {
+        fprintf(stderr, "cannot create trace file %s\n", __mt_trace_path);
+        return;
+    }
+    for (i = first; i < count; i++)
+    {
+        if (i == first || __mt_trace_events[i % MT_TRACE_EVENTS].begin_ns < origin)
+        {
+            origin = __mt_trace_events[i % MT_TRACE_EVENTS].begin_ns;
+        }
+    }
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    for (lane = 0; lane <= __mt_trace_max_lane; lane++)
+    {
+        fprintf(file, "%s{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":0,\"args\":{\"name\":\"",
+                lane ? ",\n" : "", lane);
+        if (lane)
+        {
+            fprintf(file, "worker %d\"}}", lane);
+        }
+        else
+        {
+            fprintf(file, "main\"}}");
+        }
+    }
+    for (i = first; i < count; i++)
+    {
+        const struct __mt_trace_event *event = &__mt_trace_events[i % MT_TRACE_EVENTS];
+        fprintf(file, ",\n{\"name\":\"");
+        __mt_report_escape(file, event->name, 1);
+        fprintf(file, "\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%d,\"tid\":%d}",
+                event->category, (event->begin_ns - origin) / 1E3, (event->end_ns - event->begin_ns) / 1E3,
+                event->lane, event->thread);
+    }
+    fprintf(file, "\n]}\n");
+    (void)fclose(file);
+    if (first > 0)
+    {
+        fprintf(stderr, "trace buffer is full, the earliest %lu events were dropped\n", first);
+    }
+    free(__mt_trace_events);
+    __mt_trace_events = NULL;
+    __mt_trace_state = -1;
+}
+
+static __MT_UNUSED void __mt_tap_begin(struct __mt_report_output *output)
+{
+    fprintf(output->stream, "TAP version 13\n");
+}
+static __MT_UNUSED void __mt_tap_testcase(struct __mt_report_output *output, const char *suite, const char *name,
+                                          const struct __mt_testcase_result *result)
+{
+    fprintf(output->stream, "%s %d - %s/%s\n", result->status ? "not ok" : "ok", output->count, suite, name);
+    fprintf(output->stream, "  ---\n  duration_ms: %.3f\n  cpu_ms: %.3f\n  fixture_ms: %.3f\n",
+            result->wall_ns / 1E6, result->cpu_ns / 1E6, result->fixture_ns / 1E6);
+    if (result->status)
+    {
+        fprintf(output->stream, "  message: \"");
+        __mt_report_escape(output->stream, result->message, 1);
+        fprintf(output->stream, "\"\n");
+        if (result->file)
+        {
+            fprintf(output->stream, "  file: \"");
+            __mt_report_escape(output->stream, result->file, 1);
+            fprintf(output->stream, "\"\n  line: %d\n", result->line);
+        }
+    }
+    if (result->status && result->failures > 0)
+    {
+        const struct __mt_expect_record *record = NULL;
+        size_t offset = 0;
+
+        fprintf(output->stream, "  failures: %d\n  records:\n", result->failures);
+        while (NULL != (record = __mt_expect_next(result, &offset)))
+        {
+            fprintf(output->stream, "    - message: \"");
+            __mt_report_escape(output->stream, (const char *)(record + 1), 1);
+            fprintf(output->stream, "\"\n");
+            if (record->file)
+            {
+                fprintf(output->stream, "      file: \"");
+                __mt_report_escape(output->stream, record->file, 1);
+                fprintf(output->stream, "\"\n      line: %d\n", record->line);
+            }
+        }
+    }
+    fprintf(output->stream, "  ...\n");
+}
+static __MT_UNUSED void __mt_tap_end(struct __mt_report_output *output)
+{
+    fprintf(output->stream, "1..%d\n", output->count);
+}
+
+/* JUnit报告中<testsuite>元素需要给出用例数和失败数，套件内的用例先写入临时文件，套件结束时连同元素头一并写出； */
+/* 无法创建临时文件时直接写出用例，元素头中不带统计属性 */
+static __MT_UNUSED void __mt_junit_begin(struct __mt_report_output *output)
+{
+    fprintf(output->stream, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<testsuites>\n");
+    output->pending = tmpfile();
+}
+static __MT_UNUSED void __mt_junit_header(struct __mt_report_output *output, const char *suite)
+{
+    fprintf(output->stream, "  <testsuite name=\"");
+    __mt_report_escape(output->stream, suite, 0);
+    if (output->pending)
+    {
+        fprintf(output->stream, "\" tests=\"%d\" failures=\"%d", output->suite_tests, output->suite_failures);
+    }
+    fprintf(output->stream, "\">\n");
+}
+static __MT_UNUSED void __mt_junit_suite(struct __mt_report_output *output)
+{
+    char buffer[4096];
+    long size = 0;
+    size_t length = 0;
+
+    if (NULL == output->suite)
+    {
+        return;
+    }
+    if (output->pending)
+    {
+        __mt_junit_header(output, output->suite);
+        size = ftell(output->pending);
+        rewind(output->pending);
+        while (size > 0 && (length = fread(buffer, 1, size < (long)sizeof(buffer) ? (size_t)size : sizeof(buffer),
+                                           output->pending)) > 0)
+        {
+            (void)fwrite(buffer, 1, length, output->stream);
+            size -= (long)length;
+        }
+        rewind(output->pending);
+    }
+    fprintf(output->stream, "  </testsuite>\n");
+    output->suite = NULL;
+    output->suite_tests = 0;
+    output->suite_failures = 0;
+}
+static __MT_UNUSED void __mt_junit_testcase(struct __mt_report_output *output, const char *suite, const char *name,
+                                            const struct __mt_testcase_result *result)
+{
+    FILE *stream = output->pending ? output->pending : output->stream;
+
+    if (output->suite && 0 != strcmp(output->suite, suite))
+    {
+        __mt_junit_suite(output);
+    }
+    if (NULL == output->suite && NULL == output->pending)
+    {
+        __mt_junit_header(output, suite);
+    }
+    output->suite = suite;
+    output->suite_tests++;
+    output->suite_failures += result->status ? 1 : 0;
+    fprintf(stream, "    <testcase classname=\"");
+    __mt_report_escape(stream, suite, 0);
+    fprintf(stream, "\" name=\"");
+    __mt_report_escape(stream, name, 0);
+    fprintf(stream, "\" time=\"%.6f\"", result->wall_ns / 1E9);
+    if (!result->status)
+    {
+        fprintf(stream, "/>\n");
+        return;
+    }
+    if (result->file)
+    {
+        fprintf(stream, " file=\"");
+        __mt_report_escape(stream, result->file, 0);
+        fprintf(stream, "\" line=\"%d\"", result->line);
+    }
+    fprintf(stream, ">\n      <failure type=\"%s\" message=\"", result->file ? "assertion" : "error");
+    __mt_report_escape(stream, result->message, 0);
+    fprintf(stream, "\">");
+    if (result->failures > 0)
+    {
+        const struct __mt_expect_record *record = NULL;
+        size_t offset = 0;
+
+        while (NULL != (record = __mt_expect_next(result, &offset)))
+        {
+            if (record->file)
+            {
+                __mt_report_escape(stream, record->file, 0);
+                fprintf(stream, ":%d: ", record->line);
+            }
+            __mt_report_escape(stream, (const char *)(record + 1), 0);
+            fprintf(stream, "\n");
+        }
+        fprintf(stream, "</failure>\n    </testcase>\n");
+        return;
+    }
+    if (result->file)
+    {
+        __mt_report_escape(stream, result->file, 0);
+        fprintf(stream, ":%d: ", result->line);
+    }
+    __mt_report_escape(stream, result->message, 0);
+    fprintf(stream, "</failure>\n    </testcase>\n");
+}
+static __MT_UNUSED void __mt_junit_end(struct __mt_report_output *output)
+{
+    __mt_junit_suite(output);
+    fprintf(output->stream, "</testsuites>\n");
+    if (output->pending)
+    {
+        (void)fclose(output->pending);
+        output->pending = NULL;
+    }
+}
+
+static __MT_UNUSED void __mt_jsonl_testcase(struct __mt_report_output *output, const char *suite, const char *name,
+                                            const struct __mt_testcase_result *result)
+{
+    fprintf(output->stream, "{\"suite\":\"");
+    __mt_report_escape(output->stream, suite, 1);
+    fprintf(output->stream, "\",\"name\":\"");
+    __mt_report_escape(output->stream, name, 1);
+    fprintf(output->stream, "\",\"status\":\"%s\",\"wall_ms\":%.6f,\"cpu_ms\":%.6f,\"fixture_ms\":%.6f",
+            result->status ? "failed" : "passed", result->wall_ns / 1E6, result->cpu_ns / 1E6,
+            result->fixture_ns / 1E6);
+    if (result->status)
+    {
+        fprintf(output->stream, ",\"message\":\"");
+        __mt_report_escape(output->stream, result->message, 1);
+        fprintf(output->stream, "\"");
+    }
+    if (result->file)
+    {
+        fprintf(output->stream, ",\"file\":\"");
+        __mt_report_escape(output->stream, result->file, 1);
+        fprintf(output->stream, "\",\"line\":%d", result->line);
+    }
+    if (result->status && result->failures > 0)
+    {
+        const struct __mt_expect_record *record = NULL;
+        size_t offset = 0;
+        int first = 1;
+
+        fprintf(output->stream, ",\"failures\":%d,\"records\":[", result->failures);
+        while (NULL != (record = __mt_expect_next(result, &offset)))
+        {
+            fprintf(output->stream, "%s{\"message\":\"", first ? "" : ",");
+            __mt_report_escape(output->stream, (const char *)(record + 1), 1);
+            fprintf(output->stream, "\"");
+            if (record->file)
+            {
+                fprintf(output->stream, ",\"file\":\"");
+                __mt_report_escape(output->stream, record->file, 1);
+                fprintf(output->stream, "\",\"line\":%d", record->line);
+            }
+            fprintf(output->stream, "}");
+            first = 0;
+        }
+        fprintf(output->stream, "]");
+    }
+    fprintf(output->stream, "}\n");
+}
+
+static const struct __mt_reporter __mt_reporters[] = {
+    {"tap", __mt_tap_begin, __mt_tap_testcase, NULL, __mt_tap_end},
+    {"junit", __mt_junit_begin, __mt_junit_testcase, __mt_junit_suite, __mt_junit_end},
+    {"jsonl", NULL, __mt_jsonl_testcase, NULL, NULL},
+};
+
+static void __mt_report_close(void);
+
+/* 按"KIND:FILE"格式的配置打开一个报告器，成功时返回0；首次打开时注册退出处理函数， */
+/* 未调用MT_REPORT_COUNT而直接退出时报告也能完整写出 */
+static __MT_UNUSED int __mt_report_open(const char *spec)
+{
+    const char *path = strchr(spec, ':');
+    struct __mt_report_output *output = &__mt_report_outputs[__mt_report_output_count];
+    size_t i = 0;
+
+    __mt_report_initialized = 1;
+    for (i = 0; path && i < sizeof(__mt_reporters) / sizeof(__mt_reporters[0]); i++)
+    {
+        if (strlen(__mt_reporters[i].kind) == (size_t)(path - spec) &&
+            0 == strncmp(__mt_reporters[i].kind, spec, path - spec))
+        {
+            break;
+        }
+    }
+    if (NULL == path || i == sizeof(__mt_reporters) / sizeof(__mt_reporters[0]) ||
+        __mt_report_output_count == MT_MAX_REPORTERS)
+    {
+        fprintf(stderr, "invalid report %s, expected tap:FILE, junit:FILE or jsonl:FILE\n", spec);
+        return 1;
+    }
+    memset(output, 0, sizeof(*output));
+    output->reporter = &__mt_reporters[i];
+    output->stream = fopen(path + 1, "w");
+    if (NULL == output->stream)
+    {
+        fprintf(stderr, "cannot create report file %s\n", path + 1);
+        return 1;
+    }
+    output->buffer = (char *)malloc(MT_REPORT_BUFFER_SIZE);
+    if (output->buffer)
+    {
+        (void)setvbuf(output->stream, output->buffer, _IOFBF, MT_REPORT_BUFFER_SIZE);
+    }
+    if (output->reporter->begin)
+    {
+        output->reporter->begin(output);
+    }
+    if (0 == __mt_report_output_count++)
+    {
+        (void)atexit(__mt_report_close);
+    }
+    return 0;
+}
+
+/* 将用例结果分发给所有已打开的报告器，首次调用时加载环境变量MT_REPORT中的报告器配置 */
+static __MT_UNUSED void __mt_report_dispatch(const char *name, const struct __mt_testcase_result *result)
+{
+    int i = 0;
+
+    if (!__mt_report_initialized && getenv("MT_REPORT"))
+    {
+        (void)__mt_report_open(getenv("MT_REPORT"));
+    }
+    __mt_report_initialized = 1;
+    for (i = 0; i < __mt_report_output_count; i++)
+    {
+        __mt_report_outputs[i].count++;
+        __mt_report_outputs[i].reporter->testcase(&__mt_report_outputs[i],
+                                                  __mt_current_testsuite ? __mt_current_testsuite : "default",
+                                                  name, result);
+    }
+}
+
+/* 测试套件结束时通知所有报告器并写出缓冲区中的内容，避免进程异常终止时丢失已完成套件的报告 */
+static __MT_UNUSED void __mt_report_flush(void)
+{
+    int i = 0;
+
+    for (i = 0; i < __mt_report_output_count; i++)
+    {
+        if (__mt_report_outputs[i].reporter->suite)
+        {
+            __mt_report_outputs[i].reporter->suite(&__mt_report_outputs[i]);
+        }
+        (void)fflush(__mt_report_outputs[i].stream);
+    }
+}
+
+/* 结束并关闭所有报告器，写出缓冲区中剩余的内容 */
+static void __mt_report_close(void)
+{
+    int i = 0;
+
+    for (i = 0; i < __mt_report_output_count; i++)
+    {
+        if (__mt_report_outputs[i].reporter->end)
+        {
+            __mt_report_outputs[i].reporter->end(&__mt_report_outputs[i]);
+        }
+        (void)fclose(__mt_report_outputs[i].stream);
+        free(__mt_report_outputs[i].buffer);
+    }
+    __mt_report_output_count = 0;
+}
+
+/* 控制台输出到终端时每个用例结束后立即刷新，重定向到文件或管道时由标准库缓冲后批量写出， */
+/* 并在每个测试套件结束时刷新一次 */
+static int __mt_stdout_interactive = -1;
+static __MT_UNUSED void __mt_console_flush(void)
+{
+    if (__mt_stdout_interactive < 0)
+    {
+#if __MT_HAS_POSIX
+        __mt_stdout_interactive = isatty(fileno(stdout));
+#else
+        __mt_stdout_interactive = 1;
+#endif
+    }
+    if (__mt_stdout_interactive)
+    {
+        (void)fflush(stdout);
+    }
+}
+
+/* 生成"套件名/用例名"形式的用例全名，用于过滤匹配及基线文件中的索引 */
+static __MT_UNUSED void __mt_full_name(char *buffer, size_t size, const char *name)
+{
+    (void)snprintf(buffer, size, "%s/%s",
+                   __mt_current_testsuite ? __mt_current_testsuite : "default", name);
+}
+
+/* 用例结果缓存：通过--cache=FILE（或环境变量MT_CACHE）指定缓存文件后，记录每个用例最近一次的执行状态和耗时， */
+/* 下次运行时各测试套件内的用例按"上次失败、新增或源文件有改动、其余按上次耗时从短到长"的顺序执行， */
+/* 包含上次失败用例的测试套件也会优先运行；串行测试套件内的用例保持原有顺序 */
+struct __mt_cache_entry
+{
+    char *name;     /* 用例全名（套件名/用例名），NULL表示空位 */
+    int status;     /* 最近一次的执行状态（0:成功 / 1:失败） */
+    double wall_ns; /* 最近一次的墙钟耗时（纳秒） */
+};
+static struct __mt_cache_entry *__mt_cache_entries = NULL; /* 以用例全名为键的开放寻址哈希表 */
+static size_t __mt_cache_capacity = 0;
+static size_t __mt_cache_size = 0;
+static const char *__mt_cache_path = NULL;
+static int __mt_cache_state = 0;    /* 0:尚未初始化 / 1:开启 / -1:关闭 */
+static double __mt_cache_time = 0;  /* 缓存文件上次写入的时间（秒），源文件在此之后修改过的用例视为有改动 */
+static int __mt_cache_failures = 0; /* 缓存中上次失败的用例数 */
+
+/* 运行控制选项：出现失败后跳过剩余用例，以及仅运行缓存中上次失败的用例，分别可由环境变量MT_FAIL_FAST和 */
+/* MT_RERUN_FAILED设置为1开启（-1表示尚未读取环境变量） */
+static int __mt_fail_fast = -1;
+static int __mt_rerun_failed = -1;
+static int __mt_skipped_count = 0; /* 开启fail fast后被跳过的用例数 */
+
+static __MT_UNUSED size_t __mt_cache_hash(const char *name)
+{
+    size_t hash = 2166136261u;
+    for (; *name; name++)
+    {
+        hash = (hash ^ (unsigned char)*name) * 16777619u;
+    }
+    return hash;
+}
+
+/* 查找用例全名对应的缓存记录，create非0且不存在时插入新记录（哈希表过半满时扩容），失败时返回NULL */
+static __MT_UNUSED struct __mt_cache_entry *__mt_cache_find(const char *name, int create)
+{
+    struct __mt_cache_entry *entries = NULL;
+    size_t i = 0, capacity = 0;
+
+    if (create && (__mt_cache_size + 1) * 2 > __mt_cache_capacity)
+    {
+        capacity = __mt_cache_capacity ? __mt_cache_capacity * 2 : 1024;
+        entries = (struct __mt_cache_entry *)calloc(capacity, sizeof(struct __mt_cache_entry));
+        if (NULL == entries)
+        {
+            return NULL;
+        }
+        for (i = 0; i < __mt_cache_capacity; i++)
+        {
+            if (__mt_cache_entries[i].name)
+            {
+                size_t j = __mt_cache_hash(__mt_cache_entries[i].name) % capacity;
+                while (entries[j].name)
+                {
+                    j = (j + 1) % capacity;
+                }
+                entries[j] = __mt_cache_entries[i];
+            }
+        }
+        free(__mt_cache_entries);
+        __mt_cache_entries = entries;
+        __mt_cache_capacity = capacity;
+    }
+    if (0 == __mt_cache_capacity)
+    {
+        return NULL;
+    }
+    for (i = __mt_cache_hash(name) % __mt_cache_capacity; __mt_cache_entries[i].name;
+         i = (i + 1) % __mt_cache_capacity)
+    {
+        if (0 == strcmp(__mt_cache_entries[i].name, name))
+        {
+            return &__mt_cache_entries[i];
+        }
+    }
+    if (!create || NULL == (__mt_cache_entries[i].name = (char *)malloc(strlen(name) + 1)))
+    {
+        return NULL;
+    }
+    strcpy(__mt_cache_entries[i].name, name);
+    __mt_cache_entries[i].status = 0;
+    __mt_cache_entries[i].wall_ns = 0;
+    __mt_cache_size++;
+    return &__mt_cache_entries[i];
+}
+
+/* 判断结果缓存是否开启，首次调用时加载缓存文件（文件不存在时视为空缓存） */
+static __MT_UNUSED int __mt_cache_enabled(void)
+{
+    char name[512];
+    int status = 0;
+    double wall_ns = 0;
+    FILE *file = NULL;
+    struct __mt_cache_entry *entry = NULL;
+
+    if (__MT_UNLIKELY(0 == __mt_cache_state))
+    {
+        __mt_cache_state = -1;
+        if (NULL == __mt_cache_path)
+        {
+            __mt_cache_path = getenv("MT_CACHE");
+        }
+        if (NULL == __mt_cache_path || '\0' == *__mt_cache_path)
+        {
+            return 0;
+        }
+        __mt_cache_state = 1;
+        file = fopen(__mt_cache_path, "r");
+        if (NULL == file)
+        {
+            return 1;
+        }
+        if (1 != fscanf(file, "# mintest cache v1 %lf", &__mt_cache_time))
+        {
+            fprintf(stderr, "ignore malformed result cache %s\n", __mt_cache_path);
+        }
+        else
+        {
+            while (3 == fscanf(file, "%511s %d %lf", name, &status, &wall_ns))
+            {
+                entry = __mt_cache_find(name, 1);
+                if (entry)
+                {
+                    entry->status = status;
+                    entry->wall_ns = wall_ns;
+                    __mt_cache_failures += status ? 1 : 0;
+                }
+            }
+        }
+        (void)fclose(file);
+    }
+    return 1 == __mt_cache_state;
+}
+
+/* 用例执行完成后更新其缓存记录 */
+static __MT_UNUSED void __mt_cache_update(const char *name, const struct __mt_testcase_result *result)
+{
+    char full_name[512];
+    struct __mt_cache_entry *entry = NULL;
+
+    if (!__mt_cache_enabled())
+    {
+        return;
+    }
+    __mt_full_name(full_name, sizeof(full_name), name);
+    entry = __mt_cache_find(full_name, 1);
+    if (entry)
+    {
+        entry->status = result->status;
+        entry->wall_ns = result->wall_ns;
+    }
+}
+
+/* 将缓存写回文件，本次未运行的用例保留其原有记录 */
+static __MT_UNUSED void __mt_cache_write(void)
+{
+    FILE *file = NULL;
+    size_t i = 0;
+
+    if (1 != __mt_cache_state)
+    {
+        return;
+    }
+    file = fopen(__mt_cache_path, "w");
+    if (NULL == file)
+    {
+        fprintf(stderr, "cannot write result cache %s\n", __mt_cache_path);
+        return;
+    }
+    fprintf(file, "# mintest cache v1 %.0f\n", (double)time(NULL));
+    for (i = 0; i < __mt_cache_capacity; i++)
+    {
+        if (__mt_cache_entries[i].name)
+        {
+            fprintf(file, "%s %d %.0f\n", __mt_cache_entries[i].name, __mt_cache_entries[i].status,
+                    __mt_cache_entries[i].wall_ns);
+        }
+    }
+    (void)fclose(file);
+}
+
+/* 计算用例的执行优先级（0:上次失败 / 1:新增或源文件有改动 / 2:其它），并返回上次的耗时 */
+/* 改动检测以源文件为单位：文件中任一处修改都会使该文件中的全部用例视为有改动；__FILE__是相对于编译目录的路径， */
+/* 在其它目录下运行而找不到源文件时退回到比较可执行文件（/proc/self/exe）的修改时间，重新编译过即视为有改动 */
+static __MT_UNUSED int __mt_cache_priority(const char *full_name, const char *file, double *wall_ns)
+{
+    static const char *last_file = NULL;
+    static int last_changed = 0;
+    const struct __mt_cache_entry *entry = __mt_cache_find(full_name, 0);
+
+    *wall_ns = entry ? entry->wall_ns : 0;
+    if (NULL == entry)
+    {
+        return 1;
+    }
+    if (entry->status)
+    {
+        return 0;
+    }
+#if __MT_HAS_POSIX
+    if (file && file != last_file)
+    {
+        struct stat st;
+        last_file = file;
+        last_changed = (0 == stat(file, &st) || 0 == stat("/proc/self/exe", &st)) &&
+                       (double)st.st_mtime > __mt_cache_time;
+    }
+#endif
+    return file && file == last_file && last_changed ? 1 : 2;
+}
+
+/* 判断测试套件在缓存中是否存在上次失败的用例 */
+static __MT_UNUSED int __mt_cache_testsuite_failed(const char *suite)
+{
+    size_t i = 0, len = strlen(suite);
+
+    for (i = 0; i < __mt_cache_capacity; i++)
+    {
+        if (__mt_cache_entries[i].name && __mt_cache_entries[i].status &&
+            0 == strncmp(__mt_cache_entries[i].name, suite, len) && '/' == __mt_cache_entries[i].name[len])
+        {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/* 开启fail fast且已有用例失败时返回1，被跳过的用例计入跳过数 */
+static __MT_UNUSED int __mt_fail_fast_skip(void)
+{
+    if (__mt_fail_fast < 0)
+    {
+        __mt_fail_fast = getenv("MT_FAIL_FAST") ? atoi(getenv("MT_FAIL_FAST")) : 0;
+    }
+    if (__mt_fail_fast > 0 && __mt_testcase_fail_count + __mt_benchcase_fail_count > 0)
+    {
+        __mt_skipped_count++;
+        return 1;
+    }
+    return 0;
+}
+
+/* 打印单个测试用例的执行结果（含墙钟耗时和CPU耗时），更新相关统计计数及最慢用例排行，并写入已配置的报告器 */
+static __MT_UNUSED void __mt_report_testcase(const char *name, const struct __mt_testcase_result *result)
+{
+    double trace_start = __mt_trace_begin();
+    int i = 0;
+
+    __mt_testcase_total_count++;
+    if (result->status)
+    {
+        __mt_testcase_fail_count++;
+    }
+    __mt_testsuite_body_ns += result->wall_ns;
+    __mt_testsuite_fixture_ns += result->fixture_ns;
+    __mt_total_body_ns += result->wall_ns;
+    __mt_total_fixture_ns += result->fixture_ns;
+    printf("[%c] %s %s (%.3f ms, cpu %.3f ms", result->status ? 'F' : 'P', name,
+           result->status ? "failed" : "passed", result->wall_ns / 1E6, result->cpu_ns / 1E6);
+    if (result->fixture_ns > 0)
+    {
+        printf(", fixture %.3f ms", result->fixture_ns / 1E6);
+    }
+#ifdef MT_TRACK_ALLOCATIONS
+    printf(", %zu allocs, %zu bytes, peak %zu bytes, %zu leaked blocks",
+           result->allocs.count, result->allocs.bytes, result->allocs.peak_bytes, result->allocs.live_blocks);
+#endif
+#if __MT_PERF
+    __mt_perf_print(&result->perf, 1, "");
+    if (result->perf.skipped > 0)
+    {
+        printf(", %d threshold asserts skipped", result->perf.skipped);
+        __mt_perf_skipped_total += result->perf.skipped;
+    }
+#endif
+    printf(result->status ? "):\n" : ")\n");
+    if (result->status && result->failures > 0)
+    {
+        __mt_print_expect_failures(result);
+    }
+    else if (result->status)
+    {
+        __mt_print_failure(result->file, result->line, result->message);
+    }
+    __mt_console_flush();
+    __mt_report_dispatch(name, result);
+    __mt_cache_update(name, result);
+    __mt_trace_record("report", name, trace_start);
+
+    for (i = __mt_slowest_count; i > 0 && __mt_slowest_testcases[i - 1].wall_ns < result->wall_ns; i--)
+    {
+        if (i < MT_SLOWEST_COUNT)
+        {
+            __mt_slowest_testcases[i] = __mt_slowest_testcases[i - 1];
+        }
+    }
+    if (i < MT_SLOWEST_COUNT)
+    {
+        __mt_slowest_testcases[i].name = name;
+        __mt_slowest_testcases[i].wall_ns = result->wall_ns;
+        __mt_slowest_testcases[i].cpu_ns = result->cpu_ns;
+        if (__mt_slowest_count < MT_SLOWEST_COUNT)
+        {
+            __mt_slowest_count++;
+        }
+    }
+}
+
+/* 获取用例默认超时时间：环境变量MT_TIMEOUT_MS优先于编译期配置的MT_TESTCASE_TIMEOUT_MS */
+static __MT_UNUSED long __mt_get_default_timeout_ms(void)
+{
+    const char *env = getenv("MT_TIMEOUT_MS");
+    return env ? atol(env) : (long)MT_TESTCASE_TIMEOUT_MS;
+}
+
+#if __MT_HAS_POSIX
+/* 串行执行时用例超时后由SIGALRM信号处理函数跳转回用例执行入口，结束当前用例的执行；SIGALRM是发给整个进程的信号， */
+/* 落在其它线程（如用例自己创建的线程）上时转发给执行用例的线程 */
+/* 这只是尽力而为的兜底手段：被中断的用例可能正持有malloc、stdio或用户自己的锁，此后在同一进程中运行的用例 */
+/* 有可能因此死锁，需要可靠的超时时应开启并行模式，由父进程结束超时的worker进程 */
+static sigjmp_buf __mt_timeout_jmp;
+static pthread_t __mt_timeout_thread;
+static __MT_UNUSED void __mt_timeout_handler(int sig)
+{
+    if (!pthread_equal(pthread_self(), __mt_timeout_thread))
+    {
+        (void)pthread_kill(__mt_timeout_thread, sig);
+        return;
+    }
+    siglongjmp(__mt_timeout_jmp, 1);
+}
+#endif
+
+/* 在套件中第一个被选中的用例运行前执行setup_once创建共享夹具，未配置或已创建时直接返回 */
+/* 总是在父进程中调用，保证并行模式下夹具只创建一次 */
+static __MT_UNUSED void __mt_fixture_prepare(void)
+{
+    double start = 0;
+
+    if (__mt_fixture_ready || NULL == __mt_setup_testsuite)
+    {
+        return;
+    }
+    start = __mt_now_ns();
+    __mt_fixture_context = (*__mt_setup_testsuite)();
+    __mt_fixture_ready = 1;
+    __mt_testsuite_fixture_once_ns += __mt_now_ns() - start;
+    __mt_trace_record("fixture", "setup_once", __mt_trace_enabled() ? start : 0);
+}
+
+/* 套件结束时以共享夹具上下文为参数执行teardown_once，并清空套件的夹具配置 */
+static __MT_UNUSED void __mt_fixture_release(void)
+{
+    double start = 0;
+
+    if (__mt_fixture_ready && __mt_teardown_testsuite)
+    {
+        start = __mt_now_ns();
+        (*__mt_teardown_testsuite)(__mt_fixture_context);
+        __mt_testsuite_fixture_once_ns += __mt_now_ns() - start;
+        __mt_trace_record("fixture", "teardown_once", __mt_trace_enabled() ? start : 0);
+    }
+    __mt_total_fixture_once_ns += __mt_testsuite_fixture_once_ns;
+    __mt_setup_testsuite = NULL;
+    __mt_teardown_testsuite = NULL;
+    __mt_reset_testcase = NULL;
+    __mt_fixture_context = NULL;
+    __mt_fixture_ready = 0;
+}
+
+/* 在当前进程内执行测试用例，包括用例的准备和清理工作，并统计用例逻辑执行的墙钟耗时和CPU耗时 */
+/* timeout_ms大于0时用例逻辑超时会被强制中断并判定失败（被中断用例已申请的资源不会被释放），worker进程中 */
+/* 总是以0调用，超时由父进程负责 */
+static __MT_UNUSED void __mt_execute_testcase(void (*testcase)(void), const char *name, long timeout_ms,
+                                              struct __mt_testcase_result *result)
+{
+    double wall_start = 0, cpu_start = 0, fixture_start = 0, trace_start = 0;
+
+    if (__mt_reset_testcase || __mt_setup_testcase || __mt_teardown_testcase)
+    {
+        fixture_start = __mt_now_ns();
+        if (__mt_reset_testcase)
+        {
+            trace_start = __mt_trace_begin();
+            (*__mt_reset_testcase)(__mt_fixture_context);
+            __mt_trace_record("fixture", "reset", trace_start);
+        }
+        if (__mt_setup_testcase)
+        {
+            trace_start = __mt_trace_begin();
+            (*__mt_setup_testcase)();
+            __mt_trace_record("fixture", "setup", trace_start);
+        }
+        result->fixture_ns = __mt_now_ns() - fixture_start;
+    }
+    memset(__mt_message_cache, 0, MT_MESSAGE_MAX_LEN);
+    __mt_failure_file = NULL;
+    __mt_expect_reset();
+    __mt_testcase_run_status = 0;
+#ifdef MT_TRACK_ALLOCATIONS
+    __mt_alloc_begin();
+#endif
+#if __MT_PERF
+    __mt_perf_start();
+#endif
+    __mt_shared_begin();
+    trace_start = __mt_trace_begin();
+    wall_start = __mt_now_ns();
+    cpu_start = __mt_cpu_now_ns();
+#if __MT_HAS_POSIX
+    if (timeout_ms > 0)
+    {
+        struct sigaction action, old_action;
+        struct itimerval timer;
+
+        memset(&action, 0, sizeof(action));
+        action.sa_handler = __mt_timeout_handler;
+        (void)sigemptyset(&action.sa_mask);
+        (void)sigaction(SIGALRM, &action, &old_action);
+        memset(&timer, 0, sizeof(timer));
+        __mt_timeout_thread = pthread_self();
+        if (0 == sigsetjmp(__mt_timeout_jmp, 1))
+        {
+            timer.it_value.tv_sec = timeout_ms / 1000;
+            timer.it_value.tv_usec = (timeout_ms % 1000) * 1000;
+            (void)setitimer(ITIMER_REAL, &timer, NULL);
+            (*testcase)();
+        }
+        else
+        {
+            __mt_fail(NULL, 0, "timed out after %ld ms", timeout_ms);
+            __mt_data_index = -1;
+        }
+        memset(&timer, 0, sizeof(timer));
+        (void)setitimer(ITIMER_REAL, &timer, NULL);
+        (void)sigaction(SIGALRM, &old_action, NULL);
+    }
+    else
+#endif
+    {
+        (void)timeout_ms;
+        (*testcase)();
+    }
+    __mt_shared_merge();
+    result->wall_ns = __mt_now_ns() - wall_start;
+    result->cpu_ns = __mt_cpu_now_ns() - cpu_start;
+    __mt_trace_record("testcase", name, trace_start);
+#if __MT_PERF
+    __mt_perf_stop(&result->perf);
+#endif
+#ifdef MT_TRACK_ALLOCATIONS
+    __mt_alloc_end(&result->allocs);
+#endif
+    if (__mt_teardown_testcase)
+    {
+        fixture_start = __mt_now_ns();
+        (*__mt_teardown_testcase)();
+        result->fixture_ns += __mt_now_ns() - fixture_start;
+        __mt_trace_record("fixture", "teardown", __mt_trace_enabled() ? fixture_start : 0);
+    }
+    result->status = __mt_testcase_run_status;
+    result->file = __mt_failure_file;
+    result->line = __mt_failure_line;
+    result->failures = __mt_expect_count;
+    result->failures_size = __mt_expect_used;
+    memcpy(result->message, __mt_message_cache, MT_MESSAGE_MAX_LEN);
+}
+
+/* 首次运行用例时确定并行度：未通过MT_CONFIGURE_JOBS指定时读取环境变量MT_JOBS（auto或0表示CPU核数）， */
+/* 无论来源如何都限制在[1, MT_MAX_JOBS]范围内，避免同时运行的worker数超出worker环形队列的容量 */
+static __MT_UNUSED int __mt_get_jobs(void)
+{
+    if (__mt_jobs <= 0)
+    {
+        const char *env = getenv("MT_JOBS");
+        __mt_jobs = 1;
+#if __MT_HAS_POSIX
+        if (env && (0 == strcmp(env, "auto") || 0 == strcmp(env, "0")))
+        {
+            __mt_jobs = (int)sysconf(_SC_NPROCESSORS_ONLN);
+        }
+        else if (env)
+        {
+            __mt_jobs = atoi(env);
+        }
+#else
+        (void)env;
+#endif
+    }
+    if (__mt_jobs < 1)
+    {
+        __mt_jobs = 1;
+    }
+    if (__mt_jobs > MT_MAX_JOBS)
+    {
+        __mt_jobs = MT_MAX_JOBS;
+    }
+    return __mt_jobs;
+}
+
+#if __MT_HAS_POSIX
+/* 忽略信号中断完整读取/写入指定长度的数据，返回实际完成的字节数 */
+static __MT_UNUSED size_t __mt_read_full(int fd, void *buf, size_t len)
+{
+    size_t done = 0;
+    while (done < len)
+    {
+        ssize_t n = read(fd, (char *)buf + done, len - done);
+        if (n < 0 && EINTR == errno)
+        {
+            continue;
+        }
+        if (n <= 0)
+        {
+            break;
+        }
+        done += (size_t)n;
+    }
+    return done;
+}
+static __MT_UNUSED size_t __mt_write_full(int fd, const void *buf, size_t len)
+{
+    size_t done = 0;
+    while (done < len)
+    {
+        ssize_t n = write(fd, (const char *)buf + done, len - done);
+        if (n < 0 && EINTR == errno)
+        {
+            continue;
+        }
+        if (n <= 0)
+        {
+            break;
+        }
+        done += (size_t)n;
+    }
+    return done;
+}
+
+/* 等待worker回传结果直到其超时期限，期限内管道可读（包括worker退出后管道关闭）时返回非0 */
+static __MT_UNUSED int __mt_worker_wait(const struct __mt_worker *worker)
+{
+    struct pollfd item;
+    double remaining = 0;
+    int ready = 0;
+
+    item.fd = worker->fd;
+    item.events = POLLIN;
+    item.revents = 0;
+    do
+    {
+        remaining = worker->start_ns + worker->timeout_ms * 1E6 - __mt_now_ns();
+        remaining = remaining > 0 ? remaining / 1E6 + 1 : 0;
+        ready = poll(&item, 1, remaining < 1E9 ? (int)remaining : 1000000000);
+    } while ((ready < 0 && EINTR == errno) || (0 == ready && remaining > 0));
+    return 0 != ready;
+}
+
+/* 回收最早提交的worker进程，读取其回传的执行结果并打印，崩溃或异常退出的用例同样判定为失败 */
+/* 用例配置了超时时间时由父进程计时：期限内未回传结果的worker被SIGKILL结束，超时后才完成的用例同样判定为超时 */
+/* 模糊测试统计信息及并发测试各线程统计的传递和输出函数定义在后文 */
+static int __mt_fuzz_send(int fd);
+static int __mt_fuzz_receive(int fd);
+static void __mt_fuzz_print(void);
+struct __mt_concurrent_thread;
+static int __mt_concurrent_send(int fd);
+static int __mt_concurrent_receive(int fd, struct __mt_concurrent_thread **threads, int *nthreads, long *iterations);
+static void __mt_concurrent_print(const struct __mt_concurrent_thread *threads, int nthreads, long iterations);
+
+/* 常见终止信号的名称，用于输出worker进程异常结束的原因；不依赖非标准的strsignal */
+static __MT_UNUSED const char *__mt_signal_name(int sig)
+{
+    switch (sig)
+    {
+    case SIGSEGV:
+        return "SIGSEGV";
+    case SIGBUS:
+        return "SIGBUS";
+    case SIGFPE:
+        return "SIGFPE";
+    case SIGILL:
+        return "SIGILL";
+    case SIGABRT:
+        return "SIGABRT";
+    case SIGKILL:
+        return "SIGKILL";
+    case SIGTERM:
+        return "SIGTERM";
+    case SIGALRM:
+        return "SIGALRM";
+    default:
+        return "unknown signal";
+    }
+}
+
+static __MT_UNUSED void __mt_worker_reap(void)
+{
+    struct __mt_worker *worker = &__mt_workers[__mt_worker_head];
+    struct __mt_testcase_result record;
+    struct __mt_trace_event *event = NULL;
+    struct __mt_concurrent_thread *threads = NULL;
+    unsigned long trace_count = 0;
+    long iterations = 0;
+    size_t got = 0;
+    int wstatus = 0, timed_out = 0, fuzz = 0, nthreads = 0;
+
+    memset(&record, 0, sizeof(record));
+    if (worker->timeout_ms > 0 && !__mt_worker_wait(worker))
+    {
+        (void)kill(worker->pid, SIGKILL);
+        timed_out = 1;
+    }
+    got = timed_out ? 0 : __mt_read_full(worker->fd, &record, sizeof(record));
+    /* expect失败记录读入父进程的expect内存区域，父进程在回收期间不会执行用例，区域可直接复用 */
+    if (got == sizeof(record) && (record.failures_size > sizeof(__mt_expect_arena) ||
+                                  __mt_read_full(worker->fd, __mt_expect_arena, record.failures_size) !=
+                                      record.failures_size))
+    {
+        got = 0;
+    }
+    if (got == sizeof(record) && 1 == worker->kind && 0 != __mt_fuzz_receive(worker->fd))
+    {
+        got = 0;
+    }
+    if (got == sizeof(record) && 2 == worker->kind &&
+        0 != __mt_concurrent_receive(worker->fd, &threads, &nthreads, &iterations))
+    {
+        got = 0;
+    }
+    fuzz = 1 == worker->kind && got == sizeof(record);
+    if (got == sizeof(record) && __mt_trace_enabled() &&
+        __mt_read_full(worker->fd, &trace_count, sizeof(trace_count)) == sizeof(trace_count))
+    {
+        for (; trace_count > 0; trace_count--)
+        {
+            event = &__mt_trace_events[__mt_trace_count % MT_TRACE_EVENTS];
+            if (__mt_read_full(worker->fd, event, sizeof(*event)) != sizeof(*event))
+            {
+                break;
+            }
+            __mt_trace_count++;
+        }
+    }
+    (void)close(worker->fd);
+    while (waitpid(worker->pid, &wstatus, 0) < 0 && EINTR == errno)
+    {
+    }
+    record.message[MT_MESSAGE_MAX_LEN - 1] = '\0';
+    if (timed_out || (worker->timeout_ms > 0 && got == sizeof(record) && record.wall_ns > worker->timeout_ms * 1E6))
+    {
+        memset(&record, 0, sizeof(record));
+        record.status = 1;
+        record.wall_ns = worker->timeout_ms * 1E6;
+        (void)snprintf(record.message, MT_MESSAGE_MAX_LEN, "timed out after %ld ms", worker->timeout_ms);
+    }
+    else if (WIFSIGNALED(wstatus))
+    {
+        record.status = 1;
+        record.failures = 0;
+        (void)snprintf(record.message, MT_MESSAGE_MAX_LEN,
+                       "worker process terminated by signal %d (%s)",
+                       WTERMSIG(wstatus), __mt_signal_name(WTERMSIG(wstatus)));
+    }
+    else if (got != sizeof(record) || !WIFEXITED(wstatus) || 0 != WEXITSTATUS(wstatus))
+    {
+        record.status = 1;
+        record.failures = 0;
+        (void)snprintf(record.message, MT_MESSAGE_MAX_LEN,
+                       "worker process exited unexpectedly with status %d",
+                       WIFEXITED(wstatus) ? WEXITSTATUS(wstatus) : -1);
+    }
+    __mt_report_testcase(worker->name ? worker->name : "<unknown>", &record);
+    if (fuzz)
+    {
+        __mt_fuzz_print();
+    }
+    if (threads)
+    {
+        __mt_concurrent_print(threads, nthreads, iterations);
+        free(threads);
+    }
+
+    __mt_worker_head = (__mt_worker_head + 1) % MT_MAX_JOBS;
+    __mt_worker_count--;
+}
+
+/* fork一个worker进程执行测试用例，正在运行的worker数已达上限时先等待最早提交的用例完成 */
+/* 创建进程失败时返回非0，由调用方退回到当前进程内串行执行；kind为1时是模糊测试用例，整个用例只fork一次， */
+/* kind为2时是并发测试用例，各线程都在worker进程中运行 */
+static __MT_UNUSED int __mt_worker_submit(void (*testcase)(void), const char *name, long timeout_ms, int kind)
+{
+    struct __mt_worker *worker = NULL;
+    int fds[2] = {-1, -1};
+    pid_t pid = 0;
+    int i = 0, lane = 0;
+
+    if (__mt_worker_count >= __mt_jobs)
+    {
+        __mt_worker_reap();
+    }
+    if (0 != pipe(fds))
+    {
+        return 1;
+    }
+    /* 选取当前未被占用的最小通道编号，使追踪时间线中每个通道对应一个并行执行槽位 */
+    for (lane = 1; lane <= __mt_worker_count; lane++)
+    {
+        for (i = 0; i < __mt_worker_count && __mt_workers[(__mt_worker_head + i) % MT_MAX_JOBS].lane != lane; i++)
+        {
+        }
+        if (i == __mt_worker_count)
+        {
+            break;
+        }
+    }
+    if (lane > __mt_trace_max_lane)
+    {
+        __mt_trace_max_lane = lane;
+    }
+    (void)fflush(stdout);
+    (void)fflush(stderr);
+    pid = fork();
+    if (pid < 0)
+    {
+        (void)close(fds[0]);
+        (void)close(fds[1]);
+        return 1;
+    }
+    if (0 == pid)
+    {
+        struct __mt_testcase_result record;
+        unsigned long trace_first = __mt_trace_count, trace_count = 0;
+        for (i = 0; i < __mt_worker_count; i++)
+        {
+            (void)close(__mt_workers[(__mt_worker_head + i) % MT_MAX_JOBS].fd);
+        }
+        (void)close(fds[0]);
+        __mt_trace_lane = lane;
+        memset(&record, 0, sizeof(record));
+        __mt_execute_testcase(testcase, name, 0, &record);
+        (void)fflush(stdout);
+        (void)fflush(stderr);
+        if (__mt_write_full(fds[1], &record, sizeof(record)) != sizeof(record) ||
+            __mt_write_full(fds[1], __mt_expect_arena, record.failures_size) != record.failures_size ||
+            (1 == kind && 0 != __mt_fuzz_send(fds[1])) || (2 == kind && 0 != __mt_concurrent_send(fds[1])))
+        {
+            _exit(1);
+        }
+        /* 追踪开启时在用例结果之后依次传回本进程记录的事件数及各个事件 */
+        if (__mt_trace_enabled())
+        {
+            if (__mt_trace_count - trace_first > MT_TRACE_EVENTS)
+            {
+                trace_first = __mt_trace_count - MT_TRACE_EVENTS;
+            }
+            trace_count = __mt_trace_count - trace_first;
+            if (__mt_write_full(fds[1], &trace_count, sizeof(trace_count)) != sizeof(trace_count))
+            {
+                _exit(1);
+            }
+            for (; trace_first < __mt_trace_count; trace_first++)
+            {
+                if (__mt_write_full(fds[1], &__mt_trace_events[trace_first % MT_TRACE_EVENTS],
+                                    sizeof(struct __mt_trace_event)) != sizeof(struct __mt_trace_event))
+                {
+                    _exit(1);
+                }
+            }
+        }
+        _exit(0);
+    }
+    (void)close(fds[1]);
+    worker = &__mt_workers[(__mt_worker_head + __mt_worker_count) % MT_MAX_JOBS];
+    worker->pid = pid;
+    worker->fd = fds[0];
+    worker->lane = lane;
+    worker->name = name;
+    worker->timeout_ms = timeout_ms;
+    worker->start_ns = __mt_now_ns();
+    worker->kind = kind;
+    __mt_worker_count++;
+    return 0;
+}
+#endif
+
+/* 等待所有已提交的并行用例执行完成并输出结果，串行模式下无任何操作 */
+static __MT_UNUSED void __mt_worker_drain(void)
+{
+#if __MT_HAS_POSIX
+    while (__mt_worker_count > 0)
+    {
+        __mt_worker_reap();
+    }
+#endif
+}
+
+/* 通配符匹配，pattern中'*'匹配任意长度字符串，'?'匹配任意单个字符，仅比较pattern的前pattern_len个字符 */
+static __MT_UNUSED int __mt_glob_match(const char *pattern, size_t pattern_len, const char *str)
+{
+    size_t p = 0, star_p = 0;
+    const char *star_s = NULL;
+
+    while (*str)
+    {
+        if (p < pattern_len && ('?' == pattern[p] || pattern[p] == *str))
+        {
+            p++;
+            str++;
+        }
+        else if (p < pattern_len && '*' == pattern[p])
+        {
+            star_p = ++p;
+            star_s = str;
+        }
+        else if (star_s)
+        {
+            p = star_p;
+            str = ++star_s;
+        }
+        else
+        {
+            return 0;
+        }
+    }
+    while (p < pattern_len && '*' == pattern[p])
+    {
+        p++;
+    }
+    return p == pattern_len;
+}
+
+/* 按过滤规则检查"套件名/用例名"形式的完整用例名，多个规则以':'分隔，以'-'开头的规则表示排除 */
+static __MT_UNUSED int __mt_filter_match(const char *full_name)
+{
+    const char *pattern = __mt_filter;
+    int matched = 0, has_positive = 0;
+
+    if (NULL == pattern || '\0' == *pattern)
+    {
+        return 1;
+    }
+    while (*pattern)
+    {
+        size_t len = strcspn(pattern, ":");
+        if ('-' == *pattern)
+        {
+            if (__mt_glob_match(pattern + 1, len - 1, full_name))
+            {
+                return 0;
+            }
+        }
+        else
+        {
+            has_positive = 1;
+            matched = matched || __mt_glob_match(pattern, len, full_name);
+        }
+        pattern += len;
+        if (':' == *pattern)
+        {
+            pattern++;
+        }
+    }
+    return matched || !has_positive;
+}
+
+/* 判断当前用例是否需要运行：先按过滤规则匹配，再按用例序号对分片总数取模分配到各分片 */
+/* 分片配置来自环境变量MT_SHARD_INDEX和MT_SHARD_TOTAL，同一套用例在各分片间的分配是确定且不重叠的 */
+static __MT_UNUSED int __mt_testcase_selected(const char *name)
+{
+    char full_name[512];
+    int ordinal = 0;
+
+    if (0 == __mt_shard_total)
+    {
+        const char *index = getenv("MT_SHARD_INDEX");
+        const char *total = getenv("MT_SHARD_TOTAL");
+        __mt_shard_total = total ? atoi(total) : 1;
+        __mt_shard_index = index ? atoi(index) : 0;
+        if (__mt_shard_total < 1 || __mt_shard_index < 0 || __mt_shard_index >= __mt_shard_total)
+        {
+            __mt_shard_total = 1;
+            __mt_shard_index = 0;
+        }
+    }
+    if (NULL == __mt_filter)
+    {
+        __mt_filter = getenv("MT_FILTER");
+    }
+    __mt_full_name(full_name, sizeof(full_name), name);
+    if (!__mt_filter_match(full_name))
+    {
+        return 0;
+    }
+    if (__mt_rerun_failed < 0)
+    {
+        __mt_rerun_failed = getenv("MT_RERUN_FAILED") ? atoi(getenv("MT_RERUN_FAILED")) : 0;
+    }
+    /* 仅运行上次失败的用例（缓存中没有失败用例时运行全部用例），串行测试套件存在失败用例时整体运行 */
+    if (__mt_rerun_failed > 0 && __mt_cache_enabled() && __mt_cache_failures > 0)
+    {
+        const struct __mt_cache_entry *entry = __mt_cache_find(full_name, 0);
+        const char *suite = __mt_current_testsuite ? __mt_current_testsuite : "default";
+        if (__mt_testsuite_serial ? !__mt_cache_testsuite_failed(suite) : (NULL == entry || !entry->status))
+        {
+            return 0;
+        }
+    }
+    if (__mt_testsuite_serial && __mt_testsuite_shard_ordinal >= 0)
+    {
+        ordinal = __mt_testsuite_shard_ordinal;
+    }
+    else
+    {
+        ordinal = __mt_shard_ordinal++;
+        __mt_testsuite_shard_ordinal = ordinal;
+    }
+    if (ordinal % __mt_shard_total != __mt_shard_index)
+    {
+        return 0;
+    }
+    if (__mt_list_only)
+    {
+        printf("%s\n", full_name);
+        return 0;
+    }
+    if (__mt_fail_fast_skip())
+    {
+        return 0;
+    }
+    if (__mt_current_testsuite && !__mt_testsuite_started)
+    {
+        printf("=== TEST SUITE - %s start:\n", __mt_current_testsuite);
+        __mt_testsuite_started = 1;
+    }
+    return 1;
+}
+
+/* 开启结果缓存时，测试套件函数中被选中的用例和基准测试先按调用顺序收集到执行计划中，套件函数返回后再按 */
+/* 缓存给出的优先级排序执行；加入计划时记录当时的setup、teardown、reset、串行及worker进程数配置，执行每一项前 */
+/* 恢复这些配置，因此在两次MT_RUN_*之间修改配置与不开启缓存时的效果相同 */
+struct __mt_plan_item
+{
+    int kind;                          /* 0:测试用例 / 1:并发测试用例 / 2:基准测试 / 3:模糊测试用例 / 4:范围基准测试 */
+    struct __mt_registry_entry *entry; /* 测试用例的注册项，基准测试为NULL */
+    void (*benchcase)(void);           /* 基准测试函数 */
+    void (*range_benchcase)(size_t n); /* 范围基准测试函数 */
+    size_t range_from, range_to;       /* 范围基准测试的最小及最大数据规模 */
+    int complexity;                    /* 范围基准测试声明的复杂度 */
+    int flush;                         /* 范围基准测试是否在两次调用之间清除CPU缓存 */
+    const char *name;
+    long argument;                     /* 测试用例的超时时间（毫秒）或并发测试用例每个线程的迭代次数 */
+    int nthreads;                      /* 并发测试用例的线程数 */
+    int priority;                      /* 执行优先级，数值越小越先执行，基准测试排在所有测试用例之后 */
+    double wall_ns;                    /* 上次执行的耗时，同一优先级内耗时短的先执行 */
+    size_t index;                      /* 收集顺序，保证排序稳定 */
+    void (*setup)(void);               /* 加入计划时的套件配置 */
+    void (*teardown)(void);
+    void (*reset)(void *context);
+    int serial;
+    int jobs;
+};
+static struct __mt_plan_item *__mt_plan = NULL;
+static size_t __mt_plan_size = 0;
+static size_t __mt_plan_capacity = 0;
+static int __mt_plan_collecting = 0;
+
+/* 将被选中的用例加入执行计划并返回新加入的计划项，内存不足时返回NULL，调用方应直接执行该用例 */
+static __MT_UNUSED struct __mt_plan_item *__mt_plan_append(int kind, struct __mt_registry_entry *entry,
+                                                           void (*benchcase)(void), const char *name,
+                                                           long argument, int nthreads)
+{
+    char full_name[512];
+    struct __mt_plan_item *item = NULL;
+
+    if (__mt_plan_size == __mt_plan_capacity)
+    {
+        size_t capacity = __mt_plan_capacity ? __mt_plan_capacity * 2 : 64;
+        item = (struct __mt_plan_item *)realloc(__mt_plan, capacity * sizeof(struct __mt_plan_item));
+        if (NULL == item)
+        {
+            return NULL;
+        }
+        __mt_plan = item;
+        __mt_plan_capacity = capacity;
+    }
+    item = &__mt_plan[__mt_plan_size];
+    item->kind = kind;
+    item->entry = entry;
+    item->benchcase = benchcase;
+    item->range_benchcase = NULL;
+    item->range_from = 0;
+    item->range_to = 0;
+    item->complexity = 0;
+    item->flush = 0;
+    item->name = name;
+    item->argument = argument;
+    item->nthreads = nthreads;
+    item->index = __mt_plan_size++;
+    item->setup = __mt_setup_testcase;
+    item->teardown = __mt_teardown_testcase;
+    item->reset = __mt_reset_testcase;
+    item->serial = __mt_testsuite_serial;
+    item->jobs = __mt_jobs;
+    item->wall_ns = 0;
+    item->priority = 3;
+    if (entry)
+    {
+        __mt_full_name(full_name, sizeof(full_name), name);
+        item->priority = __mt_cache_priority(full_name, entry->file, &item->wall_ns);
+    }
+    return item;
+}
+
+static __MT_UNUSED int __mt_plan_compare(const void *a, const void *b)
+{
+    const struct __mt_plan_item *pa = (const struct __mt_plan_item *)a;
+    const struct __mt_plan_item *pb = (const struct __mt_plan_item *)b;
+    if (pa->priority != pb->priority)
+    {
+        return pa->priority - pb->priority;
+    }
+    if (pa->wall_ns != pb->wall_ns)
+    {
+        return pa->wall_ns < pb->wall_ns ? -1 : 1;
+    }
+    return (pa->index > pb->index) - (pa->index < pb->index);
+}
+
+/* 运行已被选中的测试用例：并行模式下交给worker进程执行，否则在当前进程内执行并立即输出结果 */
+static __MT_UNUSED void __mt_run_selected_testcase(void (*testcase)(void), const char *name, long timeout_ms)
+{
+    struct __mt_testcase_result result;
+
+    __mt_fixture_prepare();
+#if __MT_HAS_POSIX
+    if (!__mt_testsuite_serial && __mt_get_jobs() > 1 && 0 == __mt_worker_submit(testcase, name, timeout_ms, 0))
+    {
+        return;
+    }
+#endif
+    __mt_worker_drain();
+    memset(&result, 0, sizeof(result));
+    __mt_execute_testcase(testcase, name, timeout_ms, &result);
+    __mt_report_testcase(name, &result);
+}
+
+/* 运行单个测试用例，不满足过滤或分片条件的用例会被跳过，不计入统计 */
+static __MT_UNUSED void __mt_run_testcase(struct __mt_registry_entry *entry, long timeout_ms)
+{
+    entry->referenced = 1;
+    if (!__mt_testcase_selected(entry->name))
+    {
+        return;
+    }
+    if (__mt_plan_collecting && NULL != __mt_plan_append(0, entry, NULL, entry->name, timeout_ms, 0))
+    {
+        return;
+    }
+    __mt_run_selected_testcase(entry->function, entry->name, timeout_ms);
+}
+
+#if __MT_HAS_POSIX
+/* 并发压力测试：在多个线程中同时反复执行同一个测试用例函数体，用于测试无锁队列、内存分配器等并发代码 */
+/* 各线程在自旋屏障处同时起跑以尽量制造竞争，任一线程断言失败后其余线程会在完成当前迭代后停止 */
+struct __mt_concurrent_thread
+{
+    pthread_t thread;
+    int index;       /* 线程序号 */
+    long iterations; /* 实际完成的迭代次数 */
+    double wall_ns;  /* 从屏障起跑到结束的墙钟耗时（纳秒） */
+};
+static void (*__mt_concurrent_function)(void) = NULL;
+static long __mt_concurrent_iterations = 0;
+static int __mt_concurrent_nthreads = 0;
+static volatile int __mt_concurrent_arrived = 0;
+static volatile int __mt_concurrent_failed = 0;
+static volatile int __mt_concurrent_running = 0; /* 尚未结束的线程数，串行执行超时后据此判断是否还有线程在运行 */
+static struct __mt_concurrent_thread *__mt_concurrent_threads = NULL;
+
+/* 首个断言失败的线程通过原子操作抢占记录权，将其线程局部的失败信息合并到以下变量中 */
+static int __mt_concurrent_fail_thread = 0;
+static long __mt_concurrent_fail_iteration = 0;
+static char __mt_concurrent_fail_message[MT_MESSAGE_MAX_LEN] = {0};
+static const char *__mt_concurrent_fail_file = NULL;
+static int __mt_concurrent_fail_line = 0;
+
+static void *__mt_concurrent_worker(void *argument)
+{
+    struct __mt_concurrent_thread *self = (struct __mt_concurrent_thread *)argument;
+    double start = 0;
+    long i = 0;
+
+    (void)__sync_add_and_fetch(&__mt_concurrent_arrived, 1);
+    while (__mt_concurrent_arrived < __mt_concurrent_nthreads)
+    {
+        (void)sched_yield();
+    }
+    __mt_trace_thread = self->index + 1;
+    start = __mt_now_ns();
+    for (i = 0; i < __mt_concurrent_iterations && !__mt_concurrent_failed; i++)
+    {
+        (*__mt_concurrent_function)();
+        if (__MT_UNLIKELY(__mt_testcase_run_status))
+        {
+            if (__sync_bool_compare_and_swap(&__mt_concurrent_failed, 0, 1))
+            {
+                __mt_concurrent_fail_thread = self->index;
+                __mt_concurrent_fail_iteration = i;
+                __mt_concurrent_fail_file = __mt_failure_file;
+                __mt_concurrent_fail_line = __mt_failure_line;
+                memcpy(__mt_concurrent_fail_message, __mt_message_cache, MT_MESSAGE_MAX_LEN);
+            }
+            break;
+        }
+    }
+    self->iterations = i;
+    self->wall_ns = __mt_now_ns() - start;
+    __mt_trace_record("thread", "concurrent worker", __mt_trace_enabled() ? start : 0);
+    (void)__sync_sub_and_fetch(&__mt_concurrent_running, 1);
+    return NULL;
+}
+
+/* 作为测试用例函数体在当前线程中执行：启动并等待全部线程，再将首个失败线程的断言信息写回当前用例 */
+static void __mt_concurrent_body(void)
+{
+    int i = 0, started = 0;
+
+    for (i = 0; i < __mt_concurrent_nthreads; i++)
+    {
+        __mt_concurrent_threads[i].index = i;
+        (void)__sync_add_and_fetch(&__mt_concurrent_running, 1);
+        if (0 != pthread_create(&__mt_concurrent_threads[i].thread, NULL,
+                                __mt_concurrent_worker, &__mt_concurrent_threads[i]))
+        {
+            /* 未能启动的线程视为已到达屏障，避免已启动的线程一直等待 */
+            (void)__sync_sub_and_fetch(&__mt_concurrent_running, 1);
+            (void)__sync_add_and_fetch(&__mt_concurrent_arrived, __mt_concurrent_nthreads - i);
+            break;
+        }
+        started++;
+    }
+    for (i = 0; i < started; i++)
+    {
+        (void)pthread_join(__mt_concurrent_threads[i].thread, NULL);
+    }
+    if (started < __mt_concurrent_nthreads)
+    {
+        (void)snprintf(__mt_message_cache, MT_MESSAGE_MAX_LEN, "failed to create thread %d of %d",
+                       started, __mt_concurrent_nthreads);
+        __mt_testcase_run_status = 1;
+    }
+    else if (__mt_concurrent_failed)
+    {
+        (void)snprintf(__mt_message_cache, MT_MESSAGE_MAX_LEN, "thread %d, iteration %ld: %.*s",
+                       __mt_concurrent_fail_thread, __mt_concurrent_fail_iteration,
+                       MT_MESSAGE_MAX_LEN - 64, __mt_concurrent_fail_message);
+        __mt_failure_file = __mt_concurrent_fail_file;
+        __mt_failure_line = __mt_concurrent_fail_line;
+        __mt_testcase_run_status = 1;
+    }
+}
+
+/* worker进程在用例结果之后依次传回线程数、每个线程的迭代次数及各线程的统计信息 */
+static int __mt_concurrent_send(int fd)
+{
+    size_t size = __mt_concurrent_nthreads * sizeof(struct __mt_concurrent_thread);
+
+    return __mt_write_full(fd, &__mt_concurrent_nthreads, sizeof(int)) == sizeof(int) &&
+                   __mt_write_full(fd, &__mt_concurrent_iterations, sizeof(long)) == sizeof(long) &&
+                   __mt_write_full(fd, __mt_concurrent_threads, size) == size
+               ? 0
+               : 1;
+}
+
+/* 父进程读取worker传回的各线程统计，成功时threads指向新申请的内存，由调用方释放 */
+static int __mt_concurrent_receive(int fd, struct __mt_concurrent_thread **threads, int *nthreads, long *iterations)
+{
+    size_t size = 0;
+
+    if (__mt_read_full(fd, nthreads, sizeof(int)) != sizeof(int) ||
+        __mt_read_full(fd, iterations, sizeof(long)) != sizeof(long) || *nthreads <= 0)
+    {
+        return 1;
+    }
+    size = *nthreads * sizeof(struct __mt_concurrent_thread);
+    *threads = (struct __mt_concurrent_thread *)malloc(size);
+    if (NULL == *threads || __mt_read_full(fd, *threads, size) != size)
+    {
+        free(*threads);
+        *threads = NULL;
+        return 1;
+    }
+    return 0;
+}
+
+/* 输出并发测试用例的总吞吐量及各线程的迭代次数和吞吐量 */
+static void __mt_concurrent_print(const struct __mt_concurrent_thread *threads, int nthreads, long iterations)
+{
+    double total = 0;
+    int i = 0;
+
+    for (i = 0; i < nthreads; i++)
+    {
+        if (threads[i].wall_ns > 0)
+        {
+            total += threads[i].iterations * 1E9 / threads[i].wall_ns;
+        }
+    }
+    printf("    %d threads x %ld iterations, total %.4g op/s\n", nthreads, iterations, total);
+    for (i = 0; i < nthreads; i++)
+    {
+        printf("    thread %d: %ld iterations, %.4g op/s\n", i, threads[i].iterations,
+               threads[i].wall_ns > 0 ? threads[i].iterations * 1E9 / threads[i].wall_ns : 0.0);
+    }
+    __mt_console_flush();
+}
+
+/* 以nthreads个线程各执行iterations次的方式并发运行测试用例，用例的setup和teardown只在执行用例的线程中执行一次 */
+/* 结果中额外输出各线程的迭代次数和吞吐量，内存分配统计覆盖所有线程，性能计数器仅作用于执行用例的线程 */
+/* 默认超时配置作用于整个并发运行：并行模式下交给worker进程执行，超时后由父进程连同全部线程一起结束； */
+/* 串行模式下由SIGALRM中断等待，并通知各线程在完成当前迭代后停止，仍未结束的线程只能任其运行，其统计内存不再释放 */
+static __MT_UNUSED void __mt_run_selected_concurrent(struct __mt_registry_entry *entry, int nthreads,
+                                                     long iterations)
+{
+    struct __mt_testcase_result result;
+    long timeout_ms = __mt_get_default_timeout_ms();
+    int submitted = 0;
+
+    __mt_fixture_prepare();
+    __mt_concurrent_function = entry->function;
+    __mt_concurrent_nthreads = nthreads > 0 ? nthreads : 1;
+    __mt_concurrent_iterations = iterations > 0 ? iterations : 1;
+    __mt_concurrent_arrived = 0;
+    __mt_concurrent_failed = 0;
+    __mt_concurrent_running = 0;
+    __mt_concurrent_threads = (struct __mt_concurrent_thread *)calloc(
+        __mt_concurrent_nthreads, sizeof(struct __mt_concurrent_thread));
+    memset(&result, 0, sizeof(result));
+    if (NULL == __mt_concurrent_threads)
+    {
+        __mt_worker_drain();
+        result.status = 1;
+        (void)snprintf(result.message, MT_MESSAGE_MAX_LEN, "failed to allocate %d threads", __mt_concurrent_nthreads);
+        __mt_report_testcase(entry->name, &result);
+        return;
+    }
+    /* worker进程继承上面准备好的运行参数，父进程中的统计内存在提交后即可释放 */
+    submitted = !__mt_testsuite_serial && __mt_get_jobs() > 1 &&
+                0 == __mt_worker_submit(&__mt_concurrent_body, entry->name, timeout_ms, 2);
+    if (!submitted)
+    {
+        __mt_worker_drain();
+        __mt_execute_testcase(&__mt_concurrent_body, entry->name, timeout_ms, &result);
+        __mt_report_testcase(entry->name, &result);
+        __mt_concurrent_print(__mt_concurrent_threads, __mt_concurrent_nthreads, __mt_concurrent_iterations);
+    }
+    if (__mt_concurrent_running > 0)
+    {
+        __mt_concurrent_failed = 1;
+    }
+    else
+    {
+        free(__mt_concurrent_threads);
+    }
+    __mt_concurrent_threads = NULL;
+}
+
+/* 并发运行测试用例，不满足过滤或分片条件的用例会被跳过 */
+static __MT_UNUSED void __mt_run_concurrent(struct __mt_registry_entry *entry, int nthreads, long iterations)
+{
+    entry->referenced = 1;
+    if (!__mt_testcase_selected(entry->name))
+    {
+        return;
+    }
+    if (__mt_plan_collecting && NULL != __mt_plan_append(1, entry, NULL, entry->name, iterations, nthreads))
+    {
+        return;
+    }
+    __mt_run_selected_concurrent(entry, nthreads, iterations);
+}
+#endif
+
+#if __MT_HAS_POSIX
+/* 进程内的覆盖率引导模糊测试：MT_FUZZCASE定义的用例函数体在同一进程内被生成的输入反复调用，每个输入不会fork新进程 */
+/* 输入由内置的变异器从语料库中随机选取并变异得到，能覆盖新代码路径的输入会被加入语料库（及语料库目录）中； */
+/* 在引用该头文件前定义MT_FUZZ_COVERAGE并以-fsanitize-coverage=trace-pc-guard（clang）或trace-pc（gcc）编译时， */
+/* 由下方的回调函数统计覆盖的代码路径，否则只进行无反馈的随机变异；任一断言失败或崩溃时输入会被保存到文件中 */
+struct __mt_fuzz_input
+{
+    uint8_t *data;
+    size_t size;
+};
+static struct __mt_fuzz_input __mt_fuzz_corpus[MT_FUZZ_CORPUS_MAX];
+static int __mt_fuzz_corpus_size = 0;
+static const char *__mt_fuzz_corpus_dir = NULL; /* 语料库目录，各用例分别使用其中名为"套件名-用例名"的子目录 */
+static const char *__mt_fuzz_replay_path = NULL;
+static uint64_t __mt_fuzz_random = 0;
+static unsigned long __mt_fuzz_edges = 0;       /* 已覆盖的代码路径数 */
+static unsigned long __mt_fuzz_guards = 0;      /* trace-pc-guard插桩点总数，trace-pc插桩时为0 */
+static int __mt_fuzz_feedback = 0;              /* 是否收到过覆盖率回调 */
+static unsigned long __mt_fuzz_runs = 0;        /* 上一个模糊测试用例的执行次数 */
+static double __mt_fuzz_elapsed_ns = 0;         /* 上一个模糊测试用例的执行耗时 */
+static char __mt_fuzz_crash_path[2048] = {0};   /* 失败输入的保存路径，为空表示未发生失败 */
+static const uint8_t *__mt_fuzz_current = NULL; /* 正在执行的输入，供崩溃时的信号处理函数保存 */
+static size_t __mt_fuzz_current_size = 0;
+
+#if defined(MT_FUZZ_COVERAGE) && !defined(MT_FUZZ_LIBFUZZER)
+/* 覆盖率回调函数本身不能被插桩，否则会递归调用自身；回调函数为全局符号，只能在一个编译单元中开启MT_FUZZ_COVERAGE */
+#if defined(__clang__)
+#define __MT_NO_COVERAGE __attribute__((no_sanitize("coverage")))
+#elif defined(__GNUC__) && __GNUC__ >= 12
+#define __MT_NO_COVERAGE __attribute__((no_sanitize_coverage))
+#else
+#define __MT_NO_COVERAGE
+#endif
+static __MT_UNUSED uint8_t __mt_fuzz_pc_map[1 << 13];
+static uint32_t *__mt_fuzz_guard_starts[16]; /* 各模块的trace-pc-guard插桩点范围，用于在用例之间重置覆盖率 */
+static uint32_t *__mt_fuzz_guard_stops[16];
+static int __mt_fuzz_guard_modules = 0;
+
+/* trace-pc-guard：为每个插桩点分配非0编号，插桩点首次被执行时计为新路径并将编号清0，此后的回调只有一次判断 */
+__MT_NO_COVERAGE void __sanitizer_cov_trace_pc_guard_init(uint32_t *start, uint32_t *stop);
+__MT_NO_COVERAGE void __sanitizer_cov_trace_pc_guard_init(uint32_t *start, uint32_t *stop)
+{
+    if (start < stop && 0 == *start && __mt_fuzz_guard_modules < 16)
+    {
+        __mt_fuzz_guard_starts[__mt_fuzz_guard_modules] = start;
+        __mt_fuzz_guard_stops[__mt_fuzz_guard_modules++] = stop;
+    }
+    for (; start < stop; start++)
+    {
+        if (0 == *start)
+        {
+            *start = (uint32_t)++__mt_fuzz_guards;
+        }
+    }
+}
+__MT_NO_COVERAGE void __sanitizer_cov_trace_pc_guard(uint32_t *guard);
+__MT_NO_COVERAGE void __sanitizer_cov_trace_pc_guard(uint32_t *guard)
+{
+    __mt_fuzz_feedback = 1;
+    if (*guard)
+    {
+        *guard = 0;
+        __mt_fuzz_edges++;
+    }
+}
+
+/* trace-pc（gcc）：以返回地址的哈希值作为路径编号，映射表中首次出现的编号计为新路径 */
+__MT_NO_COVERAGE void __sanitizer_cov_trace_pc(void);
+__MT_NO_COVERAGE void __sanitizer_cov_trace_pc(void)
+{
+    uintptr_t pc = (uintptr_t)__builtin_return_address(0);
+    size_t index = (size_t)((pc ^ (pc >> 16)) & (sizeof(__mt_fuzz_pc_map) * 8 - 1));
+    __mt_fuzz_feedback = 1;
+    if (__MT_UNLIKELY(!(__mt_fuzz_pc_map[index >> 3] & (1 << (index & 7)))))
+    {
+        __mt_fuzz_pc_map[index >> 3] |= (uint8_t)(1 << (index & 7));
+        __mt_fuzz_edges++;
+    }
+}
+
+/* 每个模糊测试用例开始前清空已覆盖的路径：清零映射表并重新为插桩点编号，使前面运行的代码不影响本用例的反馈 */
+static __MT_UNUSED __MT_NO_COVERAGE void __mt_fuzz_coverage_reset(void)
+{
+    uint32_t *guard = NULL;
+    uint32_t id = 0;
+    int i = 0;
+
+    memset(__mt_fuzz_pc_map, 0, sizeof(__mt_fuzz_pc_map));
+    for (i = 0; i < __mt_fuzz_guard_modules; i++)
+    {
+        for (guard = __mt_fuzz_guard_starts[i]; guard < __mt_fuzz_guard_stops[i]; guard++)
+        {
+            *guard = ++id;
+        }
+    }
+    __mt_fuzz_edges = 0;
+}
+#else
+static __MT_UNUSED void __mt_fuzz_coverage_reset(void)
+{
+    __mt_fuzz_edges = 0;
+}
+#endif
+
+/* xorshift64伪随机数，种子固定（可由环境变量MT_FUZZ_SEED指定）时同一程序的输入序列是确定的 */
+static __MT_UNUSED uint64_t __mt_fuzz_rand(void)
+{
+    __mt_fuzz_random ^= __mt_fuzz_random << 13;
+    __mt_fuzz_random ^= __mt_fuzz_random >> 7;
+    __mt_fuzz_random ^= __mt_fuzz_random << 17;
+    return __mt_fuzz_random;
+}
+
+/* 对输入随机执行1~4次变异：翻转比特、替换字节、插入/删除字节、写入边界值、复制片段或拼接语料库中的其它输入 */
+static __MT_UNUSED size_t __mt_fuzz_mutate(uint8_t *data, size_t size)
+{
+    static const uint8_t interesting[] = {0x00, 0x01, 0x7f, 0x80, 0xff, ' ', '0', '\n'};
+    const struct __mt_fuzz_input *other = NULL;
+    size_t position = 0, length = 0, from = 0;
+    int count = 1 + (int)(__mt_fuzz_rand() % 4);
+
+    while (count-- > 0)
+    {
+        uint64_t r = __mt_fuzz_rand();
+        position = size ? (size_t)(r >> 8) % size : 0;
+        switch (0 == size ? 2 : (int)(r % 7))
+        {
+        case 0:
+            data[position] ^= (uint8_t)(1 << ((r >> 4) & 7));
+            break;
+        case 1:
+            data[position] = (uint8_t)(r >> 32);
+            break;
+        case 2:
+            if (size < MT_FUZZ_MAX_LEN)
+            {
+                position = (size_t)(r >> 8) % (size + 1);
+                memmove(data + position + 1, data + position, size - position);
+                data[position] = (uint8_t)(r >> 40);
+                size++;
+            }
+            break;
+        case 3:
+            memmove(data + position, data + position + 1, size - position - 1);
+            size--;
+            break;
+        case 4:
+            data[position] = interesting[(r >> 40) % sizeof(interesting)];
+            break;
+        case 5:
+            from = (size_t)(r >> 24) % size;
+            length = 1 + (size_t)(r >> 48) % (size - (from > position ? from : position));
+            memmove(data + position, data + from, length);
+            break;
+        default:
+            other = &__mt_fuzz_corpus[(r >> 32) % (uint64_t)__mt_fuzz_corpus_size];
+            if (other->size > 0)
+            {
+                from = (size_t)(r >> 16) % other->size;
+                length = other->size - from < MT_FUZZ_MAX_LEN - position ? other->size - from
+                                                                         : MT_FUZZ_MAX_LEN - position;
+                memcpy(data + position, other->data + from, length);
+                size = position + length;
+            }
+            break;
+        }
+    }
+    return size;
+}
+
+/* 将输入复制后加入语料库，语料库已满时不再加入；dir非空时同时以输入内容的哈希值为文件名保存到该目录中 */
+static __MT_UNUSED void __mt_fuzz_corpus_add(const uint8_t *data, size_t size, const char *dir)
+{
+    char path[1024];
+    uint64_t hash = 14695981039346656037ULL;
+    FILE *file = NULL;
+    size_t i = 0;
+
+    if (__mt_fuzz_corpus_size >= MT_FUZZ_CORPUS_MAX)
+    {
+        return;
+    }
+    __mt_fuzz_corpus[__mt_fuzz_corpus_size].data = (uint8_t *)malloc(size ? size : 1);
+    if (NULL == __mt_fuzz_corpus[__mt_fuzz_corpus_size].data)
+    {
+        return;
+    }
+    memcpy(__mt_fuzz_corpus[__mt_fuzz_corpus_size].data, data, size);
+    __mt_fuzz_corpus[__mt_fuzz_corpus_size++].size = size;
+    if (NULL == dir)
+    {
+        return;
+    }
+    for (i = 0; i < size; i++)
+    {
+        hash = (hash ^ data[i]) * 1099511628211ULL;
+    }
+    (void)snprintf(path, sizeof(path), "%s/%016llx", dir, (unsigned long long)hash);
+    file = fopen(path, "wb");
+    if (file)
+    {
+        (void)fwrite(data, 1, size, file);
+        (void)fclose(file);
+    }
+}
+
+/* 读取文件的前MT_FUZZ_MAX_LEN字节，返回读取的字节数，失败时返回-1 */
+static __MT_UNUSED long __mt_fuzz_read_file(const char *path, uint8_t *data)
+{
+    FILE *file = fopen(path, "rb");
+    size_t size = 0;
+
+    if (NULL == file)
+    {
+        return -1;
+    }
+    size = fread(data, 1, MT_FUZZ_MAX_LEN, file);
+    (void)fclose(file);
+    return (long)size;
+}
+
+/* 崩溃时由信号处理函数保存正在执行的输入，之后恢复模糊测试开始前的处理方式并重新触发该信号 */
+static const int __mt_fuzz_signals[] = {SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGABRT};
+static struct sigaction __mt_fuzz_old_actions[sizeof(__mt_fuzz_signals) / sizeof(__mt_fuzz_signals[0])];
+static __MT_UNUSED void __mt_fuzz_crash_handler(int sig)
+{
+    static const char notice[] = "\n    fuzz input that crashed saved to ";
+    int fd = open(__mt_fuzz_crash_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    int i = 0;
+
+    if (fd >= 0)
+    {
+        (void)__mt_write_full(fd, __mt_fuzz_current, __mt_fuzz_current_size);
+        (void)close(fd);
+        (void)__mt_write_full(STDERR_FILENO, notice, sizeof(notice) - 1);
+        (void)__mt_write_full(STDERR_FILENO, __mt_fuzz_crash_path, strlen(__mt_fuzz_crash_path));
+        (void)__mt_write_full(STDERR_FILENO, "\n", 1);
+    }
+    for (i = 0; i < (int)(sizeof(__mt_fuzz_signals) / sizeof(__mt_fuzz_signals[0])); i++)
+    {
+        (void)sigaction(__mt_fuzz_signals[i], &__mt_fuzz_old_actions[i], NULL);
+    }
+    (void)raise(sig);
+}
+
+/* 模糊测试主循环：加载语料库后在目标时长或执行次数内反复变异并执行输入，首个失败的输入保存到失败输入目录 */
+/* （环境变量MT_FUZZ_ARTIFACTS，默认为当前目录）中名为"crash-套件名-用例名"的文件；指定了重放文件时只执行该文件一次 */
+static __MT_UNUSED void __mt_fuzz_loop(void (*body)(const uint8_t *data, size_t size), const char *name)
+{
+    struct sigaction action;
+    char full_name[512], dir[1024];
+    const char *env = NULL;
+    const char *artifacts = getenv("MT_FUZZ_ARTIFACTS");
+    uint8_t *data = (uint8_t *)malloc(MT_FUZZ_MAX_LEN);
+    double time_ns = (getenv("MT_FUZZ_TIME_MS") ? atof(getenv("MT_FUZZ_TIME_MS")) : MT_FUZZ_TIME_MS) * 1E6;
+    unsigned long max_runs = getenv("MT_FUZZ_RUNS") ? strtoul(getenv("MT_FUZZ_RUNS"), NULL, 10) : MT_FUZZ_RUNS;
+    unsigned long edges = 0;
+    double start = __mt_now_ns();
+    size_t size = 0;
+    long loaded = 0;
+    struct dirent *item = NULL;
+    DIR *corpus = NULL;
+    int i = 0;
+
+    __mt_fuzz_runs = 0;
+    __mt_fuzz_crash_path[0] = '\0';
+    __mt_fuzz_coverage_reset();
+    if (NULL == data)
+    {
+        __mt_fail(NULL, 0, "failed to allocate the fuzz input buffer");
+        return;
+    }
+    __mt_full_name(full_name, sizeof(full_name), name);
+    for (i = 0; full_name[i]; i++)
+    {
+        full_name[i] = '/' == full_name[i] ? '-' : full_name[i];
+    }
+    if (NULL == __mt_fuzz_replay_path)
+    {
+        __mt_fuzz_replay_path = getenv("MT_FUZZ_REPLAY");
+    }
+    if (__mt_fuzz_replay_path)
+    {
+        loaded = __mt_fuzz_read_file(__mt_fuzz_replay_path, data);
+        if (loaded < 0)
+        {
+            __mt_fail(NULL, 0, "cannot read fuzz input %s", __mt_fuzz_replay_path);
+        }
+        else
+        {
+            __mt_fuzz_runs = 1;
+            (*body)(data, (size_t)loaded);
+        }
+        __mt_fuzz_elapsed_ns = __mt_now_ns() - start;
+        free(data);
+        return;
+    }
+
+    env = getenv("MT_FUZZ_SEED");
+    __mt_fuzz_random = env ? strtoull(env, NULL, 0) : 0x9E3779B97F4A7C15ULL;
+    __mt_fuzz_random = __mt_fuzz_random ? __mt_fuzz_random : 1;
+    if (NULL == __mt_fuzz_corpus_dir)
+    {
+        __mt_fuzz_corpus_dir = getenv("MT_FUZZ_CORPUS");
+    }
+    __mt_fuzz_corpus_add(data, 0, NULL);
+    dir[0] = '\0';
+    if (__mt_fuzz_corpus_dir && '\0' != *__mt_fuzz_corpus_dir)
+    {
+        (void)snprintf(dir, sizeof(dir), "%s/%s", __mt_fuzz_corpus_dir, full_name);
+        (void)mkdir(__mt_fuzz_corpus_dir, 0755);
+        (void)mkdir(dir, 0755);
+        corpus = opendir(dir);
+        while (corpus && NULL != (item = readdir(corpus)))
+        {
+            char path[2048];
+            (void)snprintf(path, sizeof(path), "%s/%s", dir, item->d_name);
+            if ('.' != item->d_name[0] && (loaded = __mt_fuzz_read_file(path, data)) >= 0)
+            {
+                __mt_fuzz_corpus_add(data, (size_t)loaded, NULL);
+            }
+        }
+        if (corpus)
+        {
+            (void)closedir(corpus);
+        }
+    }
+    (void)snprintf(__mt_fuzz_crash_path, sizeof(__mt_fuzz_crash_path), "%s/crash-%s",
+                   artifacts && '\0' != *artifacts ? artifacts : ".", full_name);
+
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = __mt_fuzz_crash_handler;
+    (void)sigemptyset(&action.sa_mask);
+    for (i = 0; i < (int)(sizeof(__mt_fuzz_signals) / sizeof(__mt_fuzz_signals[0])); i++)
+    {
+        (void)sigaction(__mt_fuzz_signals[i], &action, &__mt_fuzz_old_actions[i]);
+    }
+    __mt_fuzz_current = data;
+    /* 每256次执行检查一次时长，避免计时调用成为每次执行的固定开销；没有覆盖率反馈时语料库不会增长，此时在上一个 */
+    /* 输入的基础上继续变异（每256次重新从语料库中选取），使输入能够逐渐变长 */
+    while ((0 == max_runs || __mt_fuzz_runs < max_runs) &&
+           ((__mt_fuzz_runs & 255) || __mt_now_ns() - start < time_ns))
+    {
+        if (__mt_fuzz_feedback || 0 == (__mt_fuzz_runs & 255))
+        {
+            const struct __mt_fuzz_input *seed =
+                &__mt_fuzz_corpus[__mt_fuzz_rand() % (uint64_t)__mt_fuzz_corpus_size];
+            memcpy(data, seed->data, seed->size);
+            size = seed->size;
+        }
+        size = __mt_fuzz_mutate(data, size);
+        __mt_fuzz_current_size = size;
+        edges = __mt_fuzz_edges;
+        __mt_fuzz_runs++;
+        (*body)(data, size);
+        if (__MT_UNLIKELY(__mt_testcase_run_status))
+        {
+            int fd = open(__mt_fuzz_crash_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+            if (fd < 0 || __mt_write_full(fd, data, size) != size)
+            {
+                (void)snprintf(__mt_fuzz_crash_path, sizeof(__mt_fuzz_crash_path), "<cannot write input>");
+            }
+            if (fd >= 0)
+            {
+                (void)close(fd);
+            }
+            break;
+        }
+        if (__MT_UNLIKELY(__mt_fuzz_edges != edges))
+        {
+            __mt_fuzz_corpus_add(data, size, dir[0] ? dir : NULL);
+        }
+    }
+    __mt_fuzz_elapsed_ns = __mt_now_ns() - start;
+    for (i = 0; i < (int)(sizeof(__mt_fuzz_signals) / sizeof(__mt_fuzz_signals[0])); i++)
+    {
+        (void)sigaction(__mt_fuzz_signals[i], &__mt_fuzz_old_actions[i], NULL);
+    }
+    if (!__mt_testcase_run_status)
+    {
+        __mt_fuzz_crash_path[0] = '\0';
+    }
+    __mt_fuzz_current = NULL;
+    for (i = 0; i < __mt_fuzz_corpus_size; i++)
+    {
+        free(__mt_fuzz_corpus[i].data);
+    }
+    __mt_fuzz_corpus_size = 0;
+    free(data);
+}
+
+/* worker进程执行模糊测试用例后随用例结果传回的统计信息 */
+struct __mt_fuzz_stats
+{
+    unsigned long runs;
+    double elapsed_ns;
+    unsigned long edges;
+    unsigned long guards;
+    int feedback;
+    size_t current_size;
+    char crash_path[sizeof(__mt_fuzz_crash_path)];
+};
+static int __mt_fuzz_send(int fd)
+{
+    struct __mt_fuzz_stats stats;
+
+    memset(&stats, 0, sizeof(stats));
+    stats.runs = __mt_fuzz_runs;
+    stats.elapsed_ns = __mt_fuzz_elapsed_ns;
+    stats.edges = __mt_fuzz_edges;
+    stats.guards = __mt_fuzz_guards;
+    stats.feedback = __mt_fuzz_feedback;
+    stats.current_size = __mt_fuzz_current_size;
+    memcpy(stats.crash_path, __mt_fuzz_crash_path, sizeof(stats.crash_path));
+    return __mt_write_full(fd, &stats, sizeof(stats)) == sizeof(stats) ? 0 : 1;
+}
+static int __mt_fuzz_receive(int fd)
+{
+    struct __mt_fuzz_stats stats;
+
+    if (__mt_read_full(fd, &stats, sizeof(stats)) != sizeof(stats))
+    {
+        return 1;
+    }
+    __mt_fuzz_runs = stats.runs;
+    __mt_fuzz_elapsed_ns = stats.elapsed_ns;
+    __mt_fuzz_edges = stats.edges;
+    __mt_fuzz_guards = stats.guards;
+    __mt_fuzz_feedback = stats.feedback;
+    __mt_fuzz_current_size = stats.current_size;
+    memcpy(__mt_fuzz_crash_path, stats.crash_path, sizeof(stats.crash_path));
+    __mt_fuzz_crash_path[sizeof(__mt_fuzz_crash_path) - 1] = '\0';
+    return 0;
+}
+
+/* 输出上一个模糊测试用例的执行次数、每秒执行次数及覆盖的路径数，失败时输出失败输入的保存路径 */
+static void __mt_fuzz_print(void)
+{
+    printf("    %lu runs in %.3f s, %.4g exec/s", __mt_fuzz_runs, __mt_fuzz_elapsed_ns / 1E9,
+           __mt_fuzz_elapsed_ns > 0 ? __mt_fuzz_runs * 1E9 / __mt_fuzz_elapsed_ns : 0.0);
+    if (__mt_fuzz_feedback && __mt_fuzz_guards > 0)
+    {
+        printf(", coverage %lu of %lu guards\n", __mt_fuzz_edges, __mt_fuzz_guards);
+    }
+    else if (__mt_fuzz_feedback)
+    {
+        printf(", coverage %lu pcs\n", __mt_fuzz_edges);
+    }
+    else
+    {
+        printf(", no coverage feedback\n");
+    }
+    if (__mt_fuzz_crash_path[0])
+    {
+        printf("    failing input (%zu bytes) saved to %s\n", __mt_fuzz_current_size, __mt_fuzz_crash_path);
+    }
+    __mt_console_flush();
+}
+
+/* 运行已被选中的模糊测试用例：并行模式下每个用例在一个worker进程中执行（每个用例fork一次，而非每个输入）， */
+/* 输入导致的崩溃只会结束该worker；串行模式下在当前进程内执行。结果之后输出模糊测试的统计信息 */
+static __MT_UNUSED void __mt_run_selected_fuzzcase(struct __mt_registry_entry *entry)
+{
+    struct __mt_testcase_result result;
+
+    __mt_fixture_prepare();
+    if (!__mt_testsuite_serial && __mt_get_jobs() > 1 && 0 == __mt_worker_submit(entry->function, entry->name, 0, 1))
+    {
+        return;
+    }
+    __mt_worker_drain();
+    memset(&result, 0, sizeof(result));
+    __mt_execute_testcase(entry->function, entry->name, 0, &result);
+    __mt_report_testcase(entry->name, &result);
+    __mt_fuzz_print();
+}
+
+/* 运行模糊测试用例，不满足过滤或分片条件的用例会被跳过 */
+static __MT_UNUSED void __mt_run_fuzzcase(struct __mt_registry_entry *entry)
+{
+    entry->referenced = 1;
+    if (!__mt_testcase_selected(entry->name))
+    {
+        return;
+    }
+    if (__mt_plan_collecting && NULL != __mt_plan_append(3, entry, NULL, entry->name, 0, 0))
+    {
+        return;
+    }
+    __mt_run_selected_fuzzcase(entry);
+}
+
+/* 执行单个输入并在断言失败时打印失败消息后abort，供libFuzzer将其记录为崩溃 */
+static __MT_UNUSED void __mt_fuzz_one(void (*body)(const uint8_t *data, size_t size), const uint8_t *data, size_t size)
+{
+    __mt_testcase_run_status = 0;
+    (*body)(data, size);
+    if (__mt_testcase_run_status)
+    {
+        __mt_print_failure(__mt_failure_file, __mt_failure_line, __mt_message_cache);
+        (void)fflush(stdout);
+        abort();
+    }
+}
+
+/* 定义模糊测试用例，函数体以data和size为参数名访问当前输入，可使用全部断言；由MT_RUN_FUZZCASE在测试套件中运行 */
+#define MT_FUZZCASE(case_name, data, size)                                        \
+    static void __mt_fuzzcase_body_##case_name(const uint8_t *data, size_t size); \
+    MT_TESTCASE(case_name)                                                        \
+    {                                                                             \
+        __mt_fuzz_loop(&__mt_fuzzcase_body_##case_name, #case_name);              \
+    }                                                                             \
+    static void __mt_fuzzcase_body_##case_name(const uint8_t *data, size_t size)
+
+/* 以指定模糊测试用例的函数体定义libFuzzer入口LLVMFuzzerTestOneInput，需在引用该头文件前定义MT_FUZZ_LIBFUZZER， */
+/* 并以-fsanitize=fuzzer编译链接（此时由libFuzzer提供main函数及覆盖率回调），一个程序中只能定义一个入口 */
+#ifdef MT_FUZZ_LIBFUZZER
+#define MT_FUZZ_LIBFUZZER_ENTRY(case_name)                          \
+    int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size);   \
+    int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)    \
+    {                                                               \
+        __mt_fuzz_one(&__mt_fuzzcase_body_##case_name, data, size); \
+        return 0;                                                   \
+    }
+#endif
+#endif
+
+#if __MT_HAS_POSIX
+/* 数据驱动用例的一条记录，所有指针都直接指向被映射的数据文件，不复制记录内容 */
+struct __mt_data_record
+{
+    long index;                             /* 记录序号，从0开始 */
+    long line;                              /* CSV记录所在的行号（从1开始），二进制记录为0 */
+    const char *data;                       /* 记录的起始地址 */
+    size_t size;                            /* 记录的字节数，CSV记录不含行尾的换行符 */
+    int count;                              /* CSV记录的字段数，二进制记录为0 */
+    const char *fields[MT_DATA_MAX_FIELDS]; /* CSV各字段的起始地址 */
+    size_t lengths[MT_DATA_MAX_FIELDS];     /* CSV各字段的字节数 */
+};
+
+/* 当前数据驱动用例映射的数据文件，用例超时被中断时未释放的映射在下一个数据驱动用例开始时释放 */
+static __MT_THREAD_LOCAL void *__mt_data_map = NULL;
+static __MT_THREAD_LOCAL size_t __mt_data_map_size = 0;
+
+/* 解除当前数据文件的映射 */
+static __MT_UNUSED void __mt_data_release(void)
+{
+    if (__mt_data_map)
+    {
+        (void)munmap(__mt_data_map, __mt_data_map_size);
+    }
+    __mt_data_map = NULL;
+    __mt_data_map_size = 0;
+}
+
+/* 将[begin, end)范围内的一行按逗号切分为字段写入record，字段数超过上限时返回非0 */
+static __MT_UNUSED int __mt_data_split_csv(struct __mt_data_record *record, const char *begin, const char *end)
+{
+    const char *comma = NULL;
+
+    record->count = 0;
+    while (record->count < MT_DATA_MAX_FIELDS)
+    {
+        comma = (const char *)memchr(begin, ',', (size_t)(end - begin));
+        record->fields[record->count] = begin;
+        record->lengths[record->count] = (size_t)((comma ? comma : end) - begin);
+        record->count++;
+        if (NULL == comma)
+        {
+            return 0;
+        }
+        begin = comma + 1;
+    }
+    return 1;
+}
+
+/* 映射数据文件并对每条记录执行一次用例函数体：record_size为0时按CSV格式逐行解析（跳过空行和以'#'开头的注释行）， */
+/* 否则按record_size字节的定长二进制记录切分；某条记录中出现致命失败后不再执行后续记录，非致命检查失败时继续执行 */
+static __MT_UNUSED void __mt_data_loop(void (*body)(const struct __mt_data_record *record), const char *path,
+                                       size_t record_size)
+{
+    char full_path[2048];
+    struct __mt_data_record record;
+    struct stat info;
+    const char *dir = getenv("MT_DATA_DIR");
+    const char *cursor = NULL, *end = NULL, *line_end = NULL;
+    void *map = MAP_FAILED;
+    int fd = -1;
+
+    __mt_data_release();
+    if (NULL == path)
+    {
+        __mt_fail(NULL, 0, "no data file path");
+        return;
+    }
+    if (dir && '\0' != *dir && '/' != path[0])
+    {
+        (void)snprintf(full_path, sizeof(full_path), "%s/%s", dir, path);
+    }
+    else
+    {
+        (void)snprintf(full_path, sizeof(full_path), "%s", path);
+    }
+    fd = open(full_path, O_RDONLY);
+    if (fd < 0 || 0 != fstat(fd, &info))
+    {
+        __mt_fail(NULL, 0, "cannot open data file %s: %s", full_path, strerror(errno));
+        if (fd >= 0)
+        {
+            (void)close(fd);
+        }
+        return;
+    }
+    if (info.st_size > 0)
+    {
+        map = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    (void)close(fd);
+    if (MAP_FAILED == map)
+    {
+        if (info.st_size > 0)
+        {
+            __mt_fail(NULL, 0, "cannot map data file %s: %s", full_path, strerror(errno));
+        }
+        else
+        {
+            __mt_fail(NULL, 0, "data file %s is empty", full_path);
+        }
+        return;
+    }
+    __mt_data_map = map;
+    __mt_data_map_size = (size_t)info.st_size;
+#ifdef MADV_SEQUENTIAL
+    (void)madvise(map, __mt_data_map_size, MADV_SEQUENTIAL);
+#endif
+    if (record_size > 0 && 0 != __mt_data_map_size % record_size)
+    {
+        __mt_fail(NULL, 0, "data file %s has %zu bytes, not a multiple of the record size %zu",
+                  full_path, __mt_data_map_size, record_size);
+        __mt_data_release();
+        return;
+    }
+
+    memset(&record, 0, sizeof(record));
+    cursor = (const char *)map;
+    end = cursor + __mt_data_map_size;
+    for (; cursor < end; cursor = line_end + (line_end < end))
+    {
+        if (record_size > 0)
+        {
+            record.data = cursor;
+            record.size = record_size;
+            line_end = cursor + record_size - 1;
+        }
+        else
+        {
+            record.line++;
+            line_end = (const char *)memchr(cursor, '\n', (size_t)(end - cursor));
+            line_end = line_end ? line_end : end;
+            record.data = cursor;
+            record.size = (size_t)(line_end - cursor);
+            if (record.size > 0 && '\r' == cursor[record.size - 1])
+            {
+                record.size--;
+            }
+            if (0 == record.size || '#' == cursor[0])
+            {
+                continue;
+            }
+        }
+        __mt_data_index = record.index;
+        __mt_data_line = record.line;
+        __mt_data_fatal = 0;
+        if (record_size > 0 || 0 == __mt_data_split_csv(&record, cursor, cursor + record.size))
+        {
+            (*body)(&record);
+        }
+        else
+        {
+            __mt_fail(NULL, 0, "more than %d fields (MT_DATA_MAX_FIELDS)", MT_DATA_MAX_FIELDS);
+        }
+        record.index++;
+        if (__mt_testcase_run_status && __mt_data_fatal)
+        {
+            break;
+        }
+    }
+    __mt_data_index = -1;
+    __mt_data_line = 0;
+    if (0 == record.index)
+    {
+        __mt_fail(NULL, 0, "data file %s contains no records", full_path);
+    }
+    __mt_data_release();
+}
+
+/* 将CSV记录的第i个字段复制到buffer中并去掉首尾空白，字段不存在或过长时记录非致命失败并返回非0 */
+static __MT_UNUSED int __mt_data_field_copy(const struct __mt_data_record *record, int i, char *buffer,
+                                            const char *file, int line)
+{
+    const char *begin = NULL, *end = NULL;
+
+    if (i < 0 || i >= record->count)
+    {
+        __mt_failure_fatal = 0;
+        __mt_fail(file, line, "field %d does not exist, the record has %d fields", i, record->count);
+        return 1;
+    }
+    begin = record->fields[i];
+    end = begin + record->lengths[i];
+    while (begin < end && (' ' == *begin || '\t' == *begin))
+    {
+        begin++;
+    }
+    while (end > begin && (' ' == end[-1] || '\t' == end[-1]))
+    {
+        end--;
+    }
+    if (end == begin || end - begin > MT_DATA_MAX_NUMBER_LEN)
+    {
+        __mt_failure_fatal = 0;
+        __mt_fail(file, line, "field %d \"%.*s\" is not a number", i, (int)record->lengths[i], record->fields[i]);
+        return 1;
+    }
+    memcpy(buffer, begin, (size_t)(end - begin));
+    buffer[end - begin] = '\0';
+    return 0;
+}
+
+/* 将CSV记录的第i个字段转换为long，字段不是合法的十进制整数时记录失败并返回0 */
+static __MT_UNUSED long __mt_data_field_long(const struct __mt_data_record *record, int i, const char *file, int line)
+{
+    char buffer[MT_DATA_MAX_NUMBER_LEN + 1];
+    char *stop = NULL;
+    long value = 0;
+
+    if (__mt_data_field_copy(record, i, buffer, file, line))
+    {
+        return 0;
+    }
+    errno = 0;
+    value = strtol(buffer, &stop, 10);
+    if ('\0' != *stop || 0 != errno)
+    {
+        __mt_failure_fatal = 0;
+        __mt_fail(file, line, "field %d \"%s\" is not an integer", i, buffer);
+        return 0;
+    }
+    return value;
+}
+
+/* 将CSV记录的第i个字段转换为double，字段不是合法的浮点数时记录失败并返回0 */
+static __MT_UNUSED double __mt_data_field_double(const struct __mt_data_record *record, int i, const char *file,
+                                                 int line)
+{
+    char buffer[MT_DATA_MAX_NUMBER_LEN + 1];
+    char *stop = NULL;
+    double value = 0;
+
+    if (__mt_data_field_copy(record, i, buffer, file, line))
+    {
+        return 0;
+    }
+    value = strtod(buffer, &stop);
+    if ('\0' != *stop)
+    {
+        __mt_failure_fatal = 0;
+        __mt_fail(file, line, "field %d \"%s\" is not a number", i, buffer);
+        return 0;
+    }
+    return value;
+}
+
+/* 定义CSV格式的数据驱动用例：path（相对路径基于环境变量MT_DATA_DIR，未设置时基于当前目录）指向的文件被映射到内存， */
+/* 每条记录执行一次函数体，函数体以record为参数名访问当前记录；任何失败消息前都会附加记录序号和行号 */
+/* 数据驱动用例是普通的测试用例，由MT_RUN_TESTCASE在测试套件中运行，字段不支持引号转义 */
+#define MT_DATACASE_CSV(case_name, path, record)                                       \
+    static void __mt_datacase_body_##case_name(const struct __mt_data_record *record); \
+    MT_TESTCASE(case_name)                                                             \
+    {                                                                                  \
+        __mt_data_loop(&__mt_datacase_body_##case_name, path, 0);                      \
+    }                                                                                  \
+    static void __mt_datacase_body_##case_name(const struct __mt_data_record *record)
+
+/* 定义定长二进制格式的数据驱动用例，文件由连续的record_size字节的记录组成，其它同MT_DATACASE_CSV */
+/* 映射的起始地址按页对齐，record_size是记录结构体对齐要求的整数倍时可直接用mt_data_as按结构体访问 */
+#define MT_DATACASE_BINARY(case_name, path, record_size, record)                       \
+    static void __mt_datacase_body_##case_name(const struct __mt_data_record *record); \
+    MT_TESTCASE(case_name)                                                             \
+    {                                                                                  \
+        __mt_data_loop(&__mt_datacase_body_##case_name, path, (size_t)(record_size));  \
+    }                                                                                  \
+    static void __mt_datacase_body_##case_name(const struct __mt_data_record *record)
+
+/* 访问数据驱动用例的当前记录：记录序号、按指定类型访问二进制记录、CSV字段数、字段的原始内容及长度 */
+#define mt_data_index(record) ((record)->index)
+#define mt_data_as(record, type) ((const type *)(const void *)(record)->data)
+#define mt_data_field_count(record) ((record)->count)
+#define mt_data_field(record, i) ((record)->fields[i])
+#define mt_data_field_length(record, i) ((record)->lengths[i])
+
+/* 将CSV字段转换为数值，字段缺失或格式错误时记录非致命失败并返回0，该失败不会被同一记录中随后的断言失败覆盖 */
+#define mt_data_field_long(record, i) __mt_data_field_long(record, i, __FILE__, __LINE__)
+#define mt_data_field_double(record, i) __mt_data_field_double(record, i, __FILE__, __LINE__)
+#endif
+
+/* 等待所有用例执行完成后返回失败用例数（包括断言失败及与基线相比显著变慢的基准测试） */
+static __MT_UNUSED int __mt_exit_code(void)
+{
+    __mt_worker_drain();
+    return __mt_testcase_fail_count + __mt_benchcase_fail_count + __mt_benchcase_regression_count;
+}
+
 /* 使用测试失败的用例数作为测试结束的退出状态码，没有失败用例时为0，即测试成功 */
-#define MT_EXIT_CODE __mt_testcase_fail_count
+#define MT_EXIT_CODE __mt_exit_code()
 
 /* 配置测试套件中用例的的setup和teardown接口函数，二者分别在每个用例开始前和结束后执行 */
 #define MT_TESTSUITE_CONFIGURE(setup_fn, teardown_fn) \
@@ -83,180 +3613,1526 @@ static char __mt_message_cache[MT_MESSAGE_MAX_LEN] = {0};
         __mt_teardown_testcase = teardown_fn;         \
     } while (0)
 
-/* 运行指定测试套件，并在完成后置空setup和teardown函数指针避免干扰后续测试套件的运行 */
-#define MT_RUN_TESTSUITE(testsuite)                            \
-    do                                                         \
-    {                                                          \
-        printf("=== TEST SUITE - %s start:\n", #testsuite);    \
-        __mt_testsuite_##testsuite();                          \
-        __mt_setup_testcase = NULL;                            \
-        __mt_teardown_testcase = NULL;                         \
-        printf("=== TEST SUITE - %s finish!\n\n", #testsuite); \
+/* 配置测试套件级别的共享夹具接口函数：setup_once返回夹具上下文指针（void *），在套件中第一个被选中的用例 */
+/* 运行前执行一次，teardown_once（参数为该上下文）在套件结束时执行一次，套件中所有用例均被过滤时二者都不执行 */
+#define MT_TESTSUITE_CONFIGURE_ONCE(setup_once_fn, teardown_once_fn) \
+    do                                                               \
+    {                                                                \
+        __mt_setup_testsuite = setup_once_fn;                        \
+        __mt_teardown_testsuite = teardown_once_fn;                  \
     } while (0)
 
-/* 运行指定测试用例，包括用例的准备和清理工作、相关统计计数、结果格式化打印及刷新等 */
-#define MT_RUN_TESTCASE(testcase)                          \
-    do                                                     \
-    {                                                      \
-        if (__mt_setup_testcase)                           \
-        {                                                  \
-            (*__mt_setup_testcase)();                      \
-        }                                                  \
-        memset(__mt_message_cache, 0, MT_MESSAGE_MAX_LEN); \
-        __mt_testcase_run_status = 0;                      \
-        __mt_testcase_##testcase();                        \
-        __mt_testcase_total_count++;                       \
-        if (__mt_testcase_run_status)                      \
-        {                                                  \
-            __mt_testcase_fail_count++;                    \
-            printf("[F] %s failed:\n", #testcase);         \
-            printf("    %s\n", __mt_message_cache);        \
-        }                                                  \
-        else                                               \
-        {                                                  \
-            printf("[P] %s passed\n", #testcase);          \
-        }                                                  \
-        (void)fflush(stdout);                              \
-        if (__mt_teardown_testcase)                        \
-        {                                                  \
-            (*__mt_teardown_testcase)();                   \
-        }                                                  \
+/* 配置每个用例开始前执行的夹具重置接口函数（参数为夹具上下文），先于setup执行， */
+/* 用于以较低成本恢复被上一个用例修改的共享夹具（如恢复快照），代替每个用例都完整重建夹具 */
+#define MT_TESTSUITE_CONFIGURE_RESET(reset_fn) \
+    do                                         \
+    {                                          \
+        __mt_reset_testcase = reset_fn;        \
+    } while (0)
+
+/* 设置并行执行测试用例的worker进程数，优先级高于环境变量MT_JOBS，设置为1即关闭并行执行， */
+/* 设置为0时按环境变量MT_JOBS确定，超过MT_MAX_JOBS时按MT_MAX_JOBS执行 */
+#define MT_CONFIGURE_JOBS(jobs) \
+    do                          \
+    {                           \
+        __mt_worker_drain();    \
+        __mt_jobs = (jobs);     \
+        (void)__mt_get_jobs();  \
     } while (0)
 
-/* 打印测试相关统计计数，包括测试用例的执行总数、通过数、失败数 */
-#define MT_REPORT_COUNT()                                                             \
-    do                                                                                \
-    {                                                                                 \
-        printf("!!! ==========================================================\n");   \
-        printf("!!! TEST COUNT: total %d test cases, %d passed, %d failed!\n",        \
-               __mt_testcase_total_count,                                             \
-               __mt_testcase_total_count - __mt_testcase_fail_count,                  \
-               __mt_testcase_fail_count);                                             \
-        printf("!!! ==========================================================\n\n"); \
+/* 声明当前测试套件中的用例之间存在执行顺序依赖，即使开启并行模式也在当前进程内依次执行， */
+/* 开启分片时整个套件也会被分配到同一个分片中 */
+#define MT_TESTSUITE_SERIAL()      \
+    do                             \
+    {                              \
+        __mt_worker_drain();       \
+        __mt_testsuite_serial = 1; \
     } while (0)
 
+/* 基准测试的执行函数定义在后文 */
+static void __mt_run_selected_benchcase(void (*benchcase)(void), const char *name);
+static void __mt_run_selected_range_benchcase(void (*benchcase)(size_t n), const char *name,
+                                              size_t from, size_t to, int complexity, int flush);
+
+/* 按优先级执行当前测试套件收集到的执行计划，只在相邻的非串行计划项之间排序，串行计划项保持收集顺序； */
+/* 开启fail fast时出现失败后跳过剩余用例，执行结束后恢复套件函数返回时的配置 */
+static __MT_UNUSED void __mt_plan_execute(void)
+{
+    void (*setup)(void) = __mt_setup_testcase;
+    void (*teardown)(void) = __mt_teardown_testcase;
+    void (*reset)(void *context) = __mt_reset_testcase;
+    int serial = __mt_testsuite_serial, jobs = __mt_jobs;
+    size_t i = 0, start = 0;
+
+    for (i = 0; i <= __mt_plan_size; i++)
+    {
+        if ((i == __mt_plan_size || __mt_plan[i].serial) && i > start + 1)
+        {
+            qsort(__mt_plan + start, i - start, sizeof(struct __mt_plan_item), __mt_plan_compare);
+        }
+        if (i == __mt_plan_size || __mt_plan[i].serial)
+        {
+            start = i + 1;
+        }
+    }
+    for (i = 0; i < __mt_plan_size; i++)
+    {
+        if (__mt_fail_fast_skip())
+        {
+            continue;
+        }
+        if (__mt_plan[i].serial != __mt_testsuite_serial || __mt_plan[i].jobs != __mt_jobs)
+        {
+            __mt_worker_drain();
+            __mt_testsuite_serial = __mt_plan[i].serial;
+            __mt_jobs = __mt_plan[i].jobs;
+        }
+        __mt_setup_testcase = __mt_plan[i].setup;
+        __mt_teardown_testcase = __mt_plan[i].teardown;
+        __mt_reset_testcase = __mt_plan[i].reset;
+        if (0 == __mt_plan[i].kind)
+        {
+            __mt_run_selected_testcase(__mt_plan[i].entry->function, __mt_plan[i].name, __mt_plan[i].argument);
+        }
+#if __MT_HAS_POSIX
+        else if (1 == __mt_plan[i].kind)
+        {
+            __mt_run_selected_concurrent(__mt_plan[i].entry, __mt_plan[i].nthreads, __mt_plan[i].argument);
+        }
+        else if (3 == __mt_plan[i].kind)
+        {
+            __mt_run_selected_fuzzcase(__mt_plan[i].entry);
+        }
+#endif
+        else if (4 == __mt_plan[i].kind)
+        {
+            __mt_run_selected_range_benchcase(__mt_plan[i].range_benchcase, __mt_plan[i].name,
+                                              __mt_plan[i].range_from, __mt_plan[i].range_to,
+                                              __mt_plan[i].complexity, __mt_plan[i].flush);
+        }
+        else
+        {
+            __mt_run_selected_benchcase(__mt_plan[i].benchcase, __mt_plan[i].name);
+        }
+    }
+    if (serial != __mt_testsuite_serial || jobs != __mt_jobs)
+    {
+        __mt_worker_drain();
+    }
+    __mt_setup_testcase = setup;
+    __mt_teardown_testcase = teardown;
+    __mt_reset_testcase = reset;
+    __mt_testsuite_serial = serial;
+    __mt_jobs = jobs;
+    __mt_plan_size = 0;
+}
+
+/* 运行测试套件，并在完成后置空setup和teardown函数指针避免干扰后续测试套件的运行 */
+/* 配置了共享夹具时在套件结束后执行teardown_once，并在结束提示中输出用例函数体与夹具各自的耗时 */
+/* 并行模式下会等待套件内所有用例执行完成后再结束套件，保证各套件的输出不会交错 */
+/* 套件的开始提示在第一个被选中的用例运行前才输出，所有用例均被过滤时不输出任何内容 */
+static __MT_UNUSED void __mt_run_testsuite(void (*testsuite)(void), const char *name)
+{
+    double trace_start = __mt_trace_begin();
+
+    __mt_current_testsuite = name;
+    __mt_testsuite_started = 0;
+    __mt_testsuite_shard_ordinal = -1;
+    __mt_testsuite_body_ns = 0;
+    __mt_testsuite_fixture_ns = 0;
+    __mt_testsuite_fixture_once_ns = 0;
+    __mt_plan_collecting = __mt_cache_enabled() && !__mt_list_only;
+    (*testsuite)();
+    __mt_plan_collecting = 0;
+    __mt_plan_execute();
+    __mt_worker_drain();
+    __mt_fixture_release();
+    __mt_setup_testcase = NULL;
+    __mt_teardown_testcase = NULL;
+    __mt_testsuite_serial = 0;
+    if (__mt_testsuite_started && (__mt_testsuite_fixture_ns > 0 || __mt_testsuite_fixture_once_ns > 0))
+    {
+        printf("=== TEST SUITE - %s finish! (bodies %.3f ms, fixtures %.3f ms once + %.3f ms per case)\n\n",
+               name, __mt_testsuite_body_ns / 1E6, __mt_testsuite_fixture_once_ns / 1E6,
+               __mt_testsuite_fixture_ns / 1E6);
+    }
+    else if (__mt_testsuite_started)
+    {
+        printf("=== TEST SUITE - %s finish!\n\n", name);
+    }
+    (void)fflush(stdout);
+    __mt_report_flush();
+    __mt_current_testsuite = NULL;
+    __mt_trace_record("suite", name, trace_start);
+}
+#define MT_RUN_TESTSUITE(testsuite) \
+    __mt_run_testsuite(&__mt_testsuite_##testsuite, #testsuite)
+
+/* 获取当前测试套件的共享夹具上下文并转换为指定类型的指针，未配置共享夹具时为NULL */
+#define MT_FIXTURE(type) ((type *)__mt_fixture_context)
+
+/* 运行指定测试用例，包括用例的准备和清理工作、相关统计计数、结果格式化打印及刷新等 */
+/* 通过环境变量MT_JOBS=N开启并行模式后，用例会在fork出的worker进程中执行，崩溃的用例仅判定为失败 */
+/* 通过环境变量MT_FILTER可按"套件名/用例名"通配符过滤用例，MT_SHARD_INDEX和MT_SHARD_TOTAL用于分片运行 */
+#define MT_RUN_TESTCASE(testcase) \
+    __mt_run_testcase(&__mt_testcase_entry_##testcase, __mt_get_default_timeout_ms())
+
+/* 以指定超时时间（毫秒）运行测试用例，覆盖默认超时配置，超时的用例会被中断并判定失败 */
+#define MT_RUN_TESTCASE_TIMEOUT(testcase, timeout_ms) \
+    __mt_run_testcase(&__mt_testcase_entry_##testcase, (long)(timeout_ms))
+
+#if __MT_HAS_POSIX
+/* 在nthreads个线程中并发地反复运行测试用例（各iterations次），用于对并发代码进行压力测试，需链接pthread， */
+/* 首个断言失败的线程序号和迭代序号会附加在失败消息前；MT_JOBS大于1时同样在worker进程中执行，默认超时配置 */
+/* 作用于整个并发运行，串行执行时的超时只能让各线程在完成当前迭代后停止 */
+#define MT_RUN_CONCURRENT(testcase, nthreads, iterations) \
+    __mt_run_concurrent(&__mt_testcase_entry_##testcase, (nthreads), (long)(iterations))
+
+/* 运行MT_FUZZCASE定义的模糊测试用例，时长由MT_FUZZ_TIME_MS控制；语料库目录由--fuzz-corpus=DIR（或环境变量 */
+/* MT_FUZZ_CORPUS）指定，--fuzz-replay=FILE（或MT_FUZZ_REPLAY）只以该文件的内容执行一次用于复现失败 */
+#define MT_RUN_FUZZCASE(testcase) __mt_run_fuzzcase(&__mt_testcase_entry_##testcase)
+#endif
+
+/* qsort使用的double升序比较函数 */
+static __MT_UNUSED int __mt_compare_double(const void *a, const void *b)
+{
+    double da = *(const double *)a;
+    double db = *(const double *)b;
+    return (da > db) - (da < db);
+}
+
+/* 基准测试的性能基线：通过--save-baseline=FILE（或环境变量MT_SAVE_BASELINE）将各基准测试的采样结果 */
+/* 按"套件名/用例名 采样数 采样值..."的文本格式逐行写入基线文件，通过--compare-baseline=FILE */
+/* （或环境变量MT_COMPARE_BASELINE）加载已有基线并对每个基准测试做Mann-Whitney U检验，判定其变快、变慢或不变 */
+struct __mt_baseline_entry
+{
+    char *name;      /* 基准测试全名（套件名/用例名） */
+    double *samples; /* 升序排列的采样值（纳秒/次） */
+    int count;       /* 采样数 */
+};
+static const char *__mt_baseline_save_path = NULL;
+static const char *__mt_baseline_compare_path = NULL;
+static FILE *__mt_baseline_save_file = NULL;
+static struct __mt_baseline_entry *__mt_baseline_entries = NULL;
+static int __mt_baseline_entry_count = 0;
+static int __mt_baseline_initialized = 0;
+static int __mt_baseline_verdicts[4] = {0}; /* 变快、变慢、不变、无可比较基线的基准测试数 */
+
+/* 加载基线文件，以'#'开头的行为注释，格式错误时提示并保留已解析的条目 */
+static __MT_UNUSED void __mt_baseline_load(const char *path)
+{
+    FILE *file = fopen(path, "r");
+    char name[512];
+    int count = 0, i = 0;
+
+    if (NULL == file)
+    {
+        fprintf(stderr, "cannot open baseline file %s, all benchmarks are reported without baseline\n", path);
+        return;
+    }
+    while (1 == fscanf(file, "%511s", name))
+    {
+        struct __mt_baseline_entry *entries = NULL;
+        struct __mt_baseline_entry *entry = NULL;
+
+        if ('#' == name[0])
+        {
+            (void)fscanf(file, "%*[^\n]");
+            continue;
+        }
+        entries = (struct __mt_baseline_entry *)realloc(
+            __mt_baseline_entries, (__mt_baseline_entry_count + 1) * sizeof(*entries));
+        if (1 != fscanf(file, "%d", &count) || count <= 0 || NULL == entries)
+        {
+            __mt_baseline_entries = entries ? entries : __mt_baseline_entries;
+            break;
+        }
+        __mt_baseline_entries = entries;
+        entry = &entries[__mt_baseline_entry_count];
+        entry->name = (char *)malloc(strlen(name) + 1);
+        entry->samples = (double *)malloc(count * sizeof(double));
+        entry->count = count;
+        if (NULL == entry->name || NULL == entry->samples)
+        {
+            free(entry->name);
+            free(entry->samples);
+            break;
+        }
+        strcpy(entry->name, name);
+        for (i = 0; i < count && 1 == fscanf(file, "%lf", &entry->samples[i]); i++)
+        {
+        }
+        if (i < count)
+        {
+            free(entry->name);
+            free(entry->samples);
+            break;
+        }
+        qsort(entry->samples, count, sizeof(double), __mt_compare_double);
+        __mt_baseline_entry_count++;
+    }
+    if (!feof(file))
+    {
+        fprintf(stderr, "malformed baseline file %s, only %d entries loaded\n", path, __mt_baseline_entry_count);
+    }
+    (void)fclose(file);
+}
+
+/* 首个基准测试运行前加载待比较的基线并打开待保存的基线文件，二者为同一文件时先加载后覆盖 */
+static __MT_UNUSED void __mt_baseline_init(void)
+{
+    if (__mt_baseline_initialized)
+    {
+        return;
+    }
+    __mt_baseline_initialized = 1;
+    if (NULL == __mt_baseline_compare_path)
+    {
+        __mt_baseline_compare_path = getenv("MT_COMPARE_BASELINE");
+    }
+    if (NULL == __mt_baseline_save_path)
+    {
+        __mt_baseline_save_path = getenv("MT_SAVE_BASELINE");
+    }
+    if (__mt_baseline_compare_path)
+    {
+        __mt_baseline_load(__mt_baseline_compare_path);
+    }
+    if (__mt_baseline_save_path)
+    {
+        __mt_baseline_save_file = fopen(__mt_baseline_save_path, "w");
+        if (NULL == __mt_baseline_save_file)
+        {
+            fprintf(stderr, "cannot create baseline file %s\n", __mt_baseline_save_path);
+        }
+        else
+        {
+            fprintf(__mt_baseline_save_file, "# mintest baseline v1: <suite/bench> <sample count> <samples in ns/op>\n");
+        }
+    }
+}
+
+/* Mann-Whitney U检验（秩和检验），采用带结修正和连续性修正的正态近似，返回两组采样分布相同的双侧p值 */
+/* 该检验不假设采样服从正态分布，适合存在长尾噪声的耗时数据，两组输入均需为升序 */
+static __MT_UNUSED double __mt_mann_whitney_p(const double *a, int na, const double *b, int nb)
+{
+    double rank_sum = 0, ties = 0, u = 0, mean = 0, sigma = 0, z = 0;
+    int n = na + nb, i = 0, j = 0, k = 0;
+
+    /* 归并两组有序采样，相同值的一段取平均秩 */
+    while (i < na || j < nb)
+    {
+        double value = (j >= nb || (i < na && a[i] <= b[j])) ? a[i] : b[j];
+        int count_a = 0, count_b = 0;
+        for (; i < na && a[i] == value; i++)
+        {
+            count_a++;
+        }
+        for (; j < nb && b[j] == value; j++)
+        {
+            count_b++;
+        }
+        rank_sum += count_a * (k + (count_a + count_b + 1) / 2.0);
+        ties += pow(count_a + count_b, 3) - (count_a + count_b);
+        k += count_a + count_b;
+    }
+    u = rank_sum - na * (na + 1) / 2.0;
+    mean = na * (double)nb / 2.0;
+    sigma = sqrt(na * (double)nb / 12.0 * ((n + 1) - ties / ((double)n * (n - 1))));
+    if (sigma <= 0)
+    {
+        return 1.0;
+    }
+    z = (fabs(u - mean) - 0.5) / sigma;
+    return z > 0 ? erfc(z / sqrt(2.0)) : 1.0;
+}
+
+/* 将基准测试的升序采样写入基线文件，并与已加载的基线比较，显著变慢时计入失败数 */
+static __MT_UNUSED void __mt_baseline_process(const char *name, const double *samples, int count)
+{
+    char full_name[512];
+    const struct __mt_baseline_entry *entry = NULL;
+    double before = 0, after = 0, change = 0, p = 0;
+    int i = 0;
+
+    __mt_full_name(full_name, sizeof(full_name), name);
+    if (__mt_baseline_save_file)
+    {
+        fprintf(__mt_baseline_save_file, "%s %d", full_name, count);
+        for (i = 0; i < count; i++)
+        {
+            fprintf(__mt_baseline_save_file, " %.3f", samples[i]);
+        }
+        fprintf(__mt_baseline_save_file, "\n");
+        (void)fflush(__mt_baseline_save_file);
+    }
+    if (NULL == __mt_baseline_compare_path)
+    {
+        return;
+    }
+    for (i = 0; i < __mt_baseline_entry_count && NULL == entry; i++)
+    {
+        if (0 == strcmp(__mt_baseline_entries[i].name, full_name))
+        {
+            entry = &__mt_baseline_entries[i];
+        }
+    }
+    if (NULL == entry || entry->count < 5 || count < 5)
+    {
+        __mt_baseline_verdicts[3]++;
+        printf("    baseline: %s\n", entry ? "insufficient samples, not compared" : "no baseline entry");
+        return;
+    }
+    before = entry->samples[entry->count / 2];
+    after = samples[count / 2];
+    change = before > 0 ? after / before - 1 : 0;
+    p = __mt_mann_whitney_p(entry->samples, entry->count, samples, count);
+    printf("    baseline: median %.2f -> %.2f ns/op (%+.1f%%, p=%.2g), ", before, after, change * 100, p);
+    if (p < MT_BASELINE_ALPHA && change > MT_BASELINE_MIN_CHANGE)
+    {
+        __mt_baseline_verdicts[1]++;
+        __mt_benchcase_regression_count++;
+        printf("slower (REGRESSION)\n");
+    }
+    else if (p < MT_BASELINE_ALPHA && change < -MT_BASELINE_MIN_CHANGE)
+    {
+        __mt_baseline_verdicts[0]++;
+        printf("faster\n");
+    }
+    else
+    {
+        __mt_baseline_verdicts[2]++;
+        printf("unchanged\n");
+    }
+}
+
+/* 打印测试相关统计计数，包括测试用例的执行总数、通过数、失败数及耗时最长的用例，运行过基准测试时同时打印其计数 */
+/* 开启基线比较时还会打印各判定结果的基准测试数，并在此关闭正在写入的基线文件和报告文件、写回结果缓存 */
+static __MT_UNUSED void __mt_report_count(void)
+{
+    int i = 0;
+
+    __mt_worker_drain();
+    printf("!!! ==========================================================\n");
+    printf("!!! TEST COUNT: total %d test cases, %d passed, %d failed!\n",
+           __mt_testcase_total_count,
+           __mt_testcase_total_count - __mt_testcase_fail_count,
+           __mt_testcase_fail_count);
+    if (__mt_skipped_count > 0)
+    {
+        printf("!!! FAIL FAST: %d cases skipped after the first failure!\n", __mt_skipped_count);
+    }
+    printf("!!! TEST TIME: %.3f ms in test bodies, %.3f ms in fixtures (%.3f ms once per suite, %.3f ms per case)!\n",
+           __mt_total_body_ns / 1E6, (__mt_total_fixture_once_ns + __mt_total_fixture_ns) / 1E6,
+           __mt_total_fixture_once_ns / 1E6, __mt_total_fixture_ns / 1E6);
+#if __MT_PERF
+    if (__mt_perf_skipped_total > 0)
+    {
+        printf("!!! PERF COUNTERS: hardware counters unavailable, %d threshold asserts skipped!\n",
+               __mt_perf_skipped_total);
+    }
+#endif
+    if (__mt_benchcase_total_count > 0)
+    {
+        printf("!!! BENCH COUNT: total %d bench cases, %d passed, %d failed!\n",
+               __mt_benchcase_total_count,
+               __mt_benchcase_total_count - __mt_benchcase_fail_count,
+               __mt_benchcase_fail_count);
+    }
+    if (__mt_baseline_compare_path)
+    {
+        printf("!!! BASELINE: %d faster, %d slower, %d unchanged, %d not compared!\n",
+               __mt_baseline_verdicts[0], __mt_baseline_verdicts[1],
+               __mt_baseline_verdicts[2], __mt_baseline_verdicts[3]);
+    }
+    if (__mt_baseline_save_file)
+    {
+        (void)fclose(__mt_baseline_save_file);
+        __mt_baseline_save_file = NULL;
+    }
+    __mt_report_close();
+    __mt_cache_write();
+    if (__mt_slowest_count > 0)
+    {
+        printf("!!! SLOWEST %d TEST CASES:\n", __mt_slowest_count);
+        for (i = 0; i < __mt_slowest_count; i++)
+        {
+            printf("!!!   %10.3f ms (cpu %10.3f ms)  %s\n",
+                   __mt_slowest_testcases[i].wall_ns / 1E6,
+                   __mt_slowest_testcases[i].cpu_ns / 1E6,
+                   __mt_slowest_testcases[i].name);
+        }
+    }
+    printf("!!! ==========================================================\n\n");
+}
+#define MT_REPORT_COUNT() __mt_report_count()
+
+/* 基准测试中阻止编译器将被测代码的计算结果或内存写入当作无用代码优化掉 */
+#if defined(__GNUC__)
+#define mt_do_not_optimize(value) __asm__ __volatile__("" : : "g"(value) : "memory")
+#define mt_clobber_memory() __asm__ __volatile__("" : : : "memory")
+#else
+static volatile double __mt_optimize_sink = 0;
+#define mt_do_not_optimize(value) (__mt_optimize_sink = (double)(value))
+#define mt_clobber_memory() ((void)__mt_optimize_sink)
+#endif
+
+/* 用于定义基准测试，被测代码写在函数体内，运行时函数体会在计时循环中被反复调用 */
+#define MT_BENCHCASE(bench_name) \
+    static void __mt_benchcase_##bench_name(void)
+
+/* 基准测试函数体单次调用处理的数据项数（如一次调用内循环执行的断言次数），设置后额外输出每秒处理的数据项数 */
+static double __mt_bench_items_per_op = 0;
+#define mt_bench_set_items_per_op(items) (__mt_bench_items_per_op = (double)(items))
+
+/* 运行指定基准测试，复用所在测试套件通过MT_TESTSUITE_CONFIGURE配置的setup和teardown接口 */
+#define MT_RUN_BENCHCASE(benchcase) \
+    __mt_run_benchcase(&__mt_benchcase_##benchcase, #benchcase)
+
+/* 基准测试单个采样批次：连续调用batch次被测函数并返回平均每次调用的耗时（纳秒） */
+static __MT_UNUSED double __mt_bench_batch(void (*benchcase)(void), long batch)
+{
+    long i = 0;
+    double start = __mt_now_ns();
+    for (i = 0; i < batch && !__mt_testcase_run_status; i++)
+    {
+        (*benchcase)();
+    }
+    return (__mt_now_ns() - start) / (double)batch;
+}
+
+/* 运行基准测试：先预热并估算单次耗时，据此自动确定每个采样批次的迭代次数使总耗时接近目标时长， */
+/* 最后统计各采样（每个采样是一个批次的平均耗时）的最小值、中位数、最大值及标准差，采样数不少于100时 */
+/* 额外输出p99；基准测试代码中断言失败时判定该基准测试失败 */
+static __MT_UNUSED void __mt_run_selected_benchcase(void (*benchcase)(void), const char *name)
+{
+    double samples[MT_BENCH_SAMPLES];
+    double target_ns = MT_BENCH_TIME_MS * 1E6;
+    double start = 0, elapsed = 0, mean = 0, variance = 0, trace_start = 0;
+    long warmup = 0, batch = 1;
+    const char *env = getenv("MT_BENCH_TIME_MS");
+#if __MT_PERF
+    struct __mt_perf_counters perf;
+#endif
+    int i = 0;
+
+    __mt_fixture_prepare();
+    __mt_worker_drain();
+    trace_start = __mt_trace_begin();
+    if (env && atof(env) > 0)
+    {
+        target_ns = atof(env) * 1E6;
+    }
+    __mt_baseline_init();
+    __mt_bench_items_per_op = 0;
+    if (__mt_reset_testcase)
+    {
+        (*__mt_reset_testcase)(__mt_fixture_context);
+    }
+    if (__mt_setup_testcase)
+    {
+        (*__mt_setup_testcase)();
+    }
+    memset(__mt_message_cache, 0, MT_MESSAGE_MAX_LEN);
+    __mt_failure_file = NULL;
+    __mt_expect_reset();
+    __mt_testcase_run_status = 0;
+    __mt_shared_begin();
+
+    start = __mt_now_ns();
+    do
+    {
+        (*benchcase)();
+        warmup++;
+        elapsed = __mt_now_ns() - start;
+    } while (elapsed < MT_BENCH_WARMUP_MS * 1E6 && !__mt_testcase_run_status);
+    if (target_ns / MT_BENCH_SAMPLES > elapsed / (double)warmup)
+    {
+        batch = (long)(target_ns / MT_BENCH_SAMPLES / (elapsed / (double)warmup));
+    }
+#if __MT_PERF
+    __mt_perf_start();
+#endif
+    for (i = 0; i < MT_BENCH_SAMPLES && !__mt_testcase_run_status; i++)
+    {
+        samples[i] = __mt_bench_batch(benchcase, batch);
+        mean += samples[i];
+    }
+#if __MT_PERF
+    __mt_perf_stop(&perf);
+#endif
+    __mt_shared_merge();
+
+    if (__mt_teardown_testcase)
+    {
+        (*__mt_teardown_testcase)();
+    }
+    __mt_benchcase_total_count++;
+    if (__mt_testcase_run_status)
+    {
+        __mt_benchcase_fail_count++;
+        printf("[F] %s failed:\n", name);
+        __mt_print_failure(__mt_failure_file, __mt_failure_line, __mt_message_cache);
+        (void)fflush(stdout);
+        __mt_trace_record("bench", name, trace_start);
+        return;
+    }
+    mean /= MT_BENCH_SAMPLES;
+    for (i = 0; i < MT_BENCH_SAMPLES; i++)
+    {
+        variance += (samples[i] - mean) * (samples[i] - mean);
+    }
+    qsort(samples, MT_BENCH_SAMPLES, sizeof(double), __mt_compare_double);
+    printf("[B] %s: %.2f ns/op, %.4g op/s", name, mean, 1E9 / mean);
+    if (__mt_bench_items_per_op > 0)
+    {
+        printf(", %.4g items/s", __mt_bench_items_per_op * 1E9 / mean);
+    }
+#if __MT_PERF
+    __mt_perf_print(&perf, (double)MT_BENCH_SAMPLES * (double)batch, "/op");
+#endif
+    printf("\n");
+    printf("    min %.2f, median %.2f, ", samples[0], samples[MT_BENCH_SAMPLES / 2]);
+#if MT_BENCH_SAMPLES >= 100
+    printf("p99 %.2f, ", samples[(MT_BENCH_SAMPLES * 99 + 99) / 100 - 1]);
+#endif
+    printf("max %.2f, stddev %.2f ns/op (%d samples x %ld iterations)\n", samples[MT_BENCH_SAMPLES - 1],
+           sqrt(variance / MT_BENCH_SAMPLES), MT_BENCH_SAMPLES, batch);
+    __mt_baseline_process(name, samples, MT_BENCH_SAMPLES);
+    (void)fflush(stdout);
+    __mt_trace_record("bench", name, trace_start);
+}
+
+/* 运行基准测试，不满足过滤或分片条件的基准测试会被跳过 */
+static __MT_UNUSED void __mt_run_benchcase(void (*benchcase)(void), const char *name)
+{
+    if (!__mt_testcase_selected(name))
+    {
+        return;
+    }
+    if (__mt_plan_collecting && NULL != __mt_plan_append(2, NULL, benchcase, name, 0, 0))
+    {
+        return;
+    }
+    __mt_run_selected_benchcase(benchcase, name);
+}
+
+/* 范围基准测试声明的时间复杂度，按增长速度从低到高排列 */
+#define MT_O_1 (0)
+#define MT_O_LOG_N (1)
+#define MT_O_N (2)
+#define MT_O_N_LOG_N (3)
+#define MT_O_N_SQUARED (4)
+#define __MT_COMPLEXITY_COUNT (5)
+static const char *const __mt_complexity_names[__MT_COMPLEXITY_COUNT] = {
+    "O(1)", "O(log n)", "O(n)", "O(n log n)", "O(n^2)"};
+
+/* 用于定义范围基准测试，函数体以数据规模n为参数，运行时在多个规模下分别计时并拟合耗时随n的增长曲线 */
+#define MT_BENCHCASE_RANGE(bench_name, n) \
+    static void __mt_range_benchcase_##bench_name(size_t n)
+
+/* 范围基准测试函数体单次调用处理的字节数（通常与n相关），设置后表格中额外输出每秒处理的字节数 */
+static double __mt_bench_bytes_per_op = 0;
+#define mt_bench_set_bytes_per_op(bytes) (__mt_bench_bytes_per_op = (double)(bytes))
+
+/* 运行范围基准测试：数据规模从from开始每次翻倍直到to，拟合出的复杂度劣于声明的complexity时判定失败 */
+#define MT_RUN_BENCHCASE_RANGE(benchcase, from, to, complexity)             \
+    __mt_run_range_benchcase(&__mt_range_benchcase_##benchcase, #benchcase, \
+                             (size_t)(from), (size_t)(to), complexity, 0)
+
+/* 同MT_RUN_BENCHCASE_RANGE，但每次调用前都先清除CPU缓存，测量数据不在缓存中时的冷启动耗时 */
+#define MT_RUN_BENCHCASE_RANGE_COLD(benchcase, from, to, complexity)        \
+    __mt_run_range_benchcase(&__mt_range_benchcase_##benchcase, #benchcase, \
+                             (size_t)(from), (size_t)(to), complexity, 1)
+
+/* 读写一块大于末级缓存的缓冲区，把被测代码的数据挤出CPU缓存，缓冲区首次使用时分配，分配失败时不清除 */
+static __MT_UNUSED void __mt_bench_flush_cache(void)
+{
+    static volatile unsigned char *buffer = NULL;
+    size_t i = 0;
+
+    if (NULL == buffer)
+    {
+        buffer = (volatile unsigned char *)calloc(MT_BENCH_FLUSH_BYTES, 1);
+    }
+    for (i = 0; buffer && i < MT_BENCH_FLUSH_BYTES; i += 64)
+    {
+        buffer[i]++;
+    }
+}
+
+/* 范围基准测试单个采样批次：连续调用batch次被测函数并返回平均每次调用的耗时（纳秒），清除缓存的耗时不计入 */
+static __MT_UNUSED double __mt_range_bench_batch(void (*benchcase)(size_t n), size_t n, long batch, int flush)
+{
+    long i = 0;
+    double start = 0, elapsed = 0;
+
+    if (!flush)
+    {
+        start = __mt_now_ns();
+        for (i = 0; i < batch && !__mt_testcase_run_status; i++)
+        {
+            (*benchcase)(n);
+        }
+        return (__mt_now_ns() - start) / (double)batch;
+    }
+    for (i = 0; i < batch && !__mt_testcase_run_status; i++)
+    {
+        __mt_bench_flush_cache();
+        start = __mt_now_ns();
+        (*benchcase)(n);
+        elapsed += __mt_now_ns() - start;
+    }
+    return elapsed / (double)batch;
+}
+
+/* 复杂度对应的增长函数 */
+static __MT_UNUSED double __mt_complexity_value(int complexity, double n)
+{
+    switch (complexity)
+    {
+    case MT_O_1:
+        return 1;
+    case MT_O_LOG_N:
+        return log2(n);
+    case MT_O_N:
+        return n;
+    case MT_O_N_LOG_N:
+        return n * log2(n);
+    default:
+        return n * n;
+    }
+}
+
+/* 对每种复杂度f(n)在对数空间中用最小二乘法拟合 log t(n) = log c + log f(n)，即log c取log(t / f)的平均值， */
+/* 以残差的均方根（约等于相对误差）写入rms，使各个规模的测量值权重相同，不会被最大规模的耗时主导； */
+/* 返回误差最小的复杂度 */
+static __MT_UNUSED int __mt_complexity_fit(const size_t *sizes, const double *times, int count, double *rms)
+{
+    double residuals[MT_BENCH_RANGE_MAX_STEPS];
+    double mean = 0, error = 0, f = 0;
+    int best = 0, complexity = 0, i = 0;
+
+    for (complexity = 0; complexity < __MT_COMPLEXITY_COUNT; complexity++)
+    {
+        mean = 0;
+        for (i = 0; i < count; i++)
+        {
+            f = __mt_complexity_value(complexity, (double)sizes[i]);
+            residuals[i] = log(times[i] > 1E-3 ? times[i] : 1E-3) - log(f > 1 ? f : 1);
+            mean += residuals[i] / count;
+        }
+        error = 0;
+        for (i = 0; i < count; i++)
+        {
+            error += (residuals[i] - mean) * (residuals[i] - mean);
+        }
+        rms[complexity] = count > 0 ? sqrt(error / count) : 0;
+        if (rms[complexity] < rms[best])
+        {
+            best = complexity;
+        }
+    }
+    return best;
+}
+
+/* 运行范围基准测试：在每个数据规模下先调用一次预热并估算单次耗时，据此确定采样批次的迭代次数， */
+/* 使所有规模的总耗时接近目标时长，取各采样的中位数作为该规模的耗时，最后输出各规模的耗时表格并拟合复杂度， */
+/* 基准测试代码中断言失败或拟合出的复杂度劣于声明时判定该基准测试失败 */
+static __MT_UNUSED void __mt_run_selected_range_benchcase(void (*benchcase)(size_t n), const char *name,
+                                                          size_t from, size_t to, int complexity, int flush)
+{
+    size_t sizes[MT_BENCH_RANGE_MAX_STEPS];
+    double times[MT_BENCH_RANGE_MAX_STEPS], bytes[MT_BENCH_RANGE_MAX_STEPS], items[MT_BENCH_RANGE_MAX_STEPS];
+    double samples[MT_BENCH_RANGE_SAMPLES];
+    double rms[__MT_COMPLEXITY_COUNT];
+    double target_ns = MT_BENCH_TIME_MS * 1E6;
+    double start = 0, elapsed = 0, trace_start = 0;
+    const char *env = getenv("MT_BENCH_TIME_MS");
+    size_t n = 0;
+    long batch = 1;
+    int steps = 0, count = 0, fitted = 0, i = 0;
+
+    for (n = from > 0 ? from : 1; n <= to && steps < MT_BENCH_RANGE_MAX_STEPS; n *= 2)
+    {
+        sizes[steps++] = n;
+    }
+    __mt_fixture_prepare();
+    __mt_worker_drain();
+    trace_start = __mt_trace_begin();
+    if (env && atof(env) > 0)
+    {
+        target_ns = atof(env) * 1E6;
+    }
+    if (__mt_reset_testcase)
+    {
+        (*__mt_reset_testcase)(__mt_fixture_context);
+    }
+    if (__mt_setup_testcase)
+    {
+        (*__mt_setup_testcase)();
+    }
+    memset(__mt_message_cache, 0, MT_MESSAGE_MAX_LEN);
+    __mt_failure_file = NULL;
+    __mt_expect_reset();
+    __mt_testcase_run_status = 0;
+    __mt_shared_begin();
+
+    for (count = 0; count < steps && !__mt_testcase_run_status; count++)
+    {
+        __mt_bench_bytes_per_op = 0;
+        __mt_bench_items_per_op = 0;
+        start = __mt_now_ns();
+        if (flush)
+        {
+            __mt_bench_flush_cache();
+        }
+        (*benchcase)(sizes[count]);
+        elapsed = __mt_now_ns() - start;
+        batch = 1;
+        if (elapsed > 0 && target_ns / steps / MT_BENCH_RANGE_SAMPLES > elapsed)
+        {
+            batch = (long)(target_ns / steps / MT_BENCH_RANGE_SAMPLES / elapsed);
+        }
+        for (i = 0; i < MT_BENCH_RANGE_SAMPLES && !__mt_testcase_run_status; i++)
+        {
+            samples[i] = __mt_range_bench_batch(benchcase, sizes[count], batch, flush);
+        }
+        qsort(samples, MT_BENCH_RANGE_SAMPLES, sizeof(double), __mt_compare_double);
+        times[count] = samples[MT_BENCH_RANGE_SAMPLES / 2];
+        bytes[count] = __mt_bench_bytes_per_op;
+        items[count] = __mt_bench_items_per_op;
+    }
+    __mt_shared_merge();
+
+    if (__mt_teardown_testcase)
+    {
+        (*__mt_teardown_testcase)();
+    }
+    __mt_benchcase_total_count++;
+    if (__mt_testcase_run_status)
+    {
+        __mt_benchcase_fail_count++;
+        printf("[F] %s failed at n = %lu:\n", name, (unsigned long)sizes[count - 1]);
+        __mt_print_failure(__mt_failure_file, __mt_failure_line, __mt_message_cache);
+        (void)fflush(stdout);
+        __mt_trace_record("bench", name, trace_start);
+        return;
+    }
+    fitted = __mt_complexity_fit(sizes, times, count, rms);
+    if (count >= 3 && fitted > complexity && rms[complexity] > rms[fitted] + MT_BENCH_COMPLEXITY_TOLERANCE)
+    {
+        __mt_benchcase_fail_count++;
+        printf("[F] %s failed:\n", name);
+        printf("    fitted complexity %s is worse than declared %s (log error %.3f vs %.3f)\n",
+               __mt_complexity_names[fitted], __mt_complexity_names[complexity], rms[fitted], rms[complexity]);
+    }
+    else if (count >= 3)
+    {
+        printf("[B] %s: fitted %s, declared %s%s\n", name, __mt_complexity_names[fitted],
+               __mt_complexity_names[complexity], flush ? ", cold cache" : "");
+    }
+    else
+    {
+        printf("[B] %s: too few sizes to fit complexity%s\n", name, flush ? ", cold cache" : "");
+    }
+    printf("    %12s %14s %12s %12s %12s\n", "n", "ns/op", "ns/n", "bytes/s", "items/s");
+    for (i = 0; i < count; i++)
+    {
+        printf("    %12lu %14.2f %12.4f", (unsigned long)sizes[i], times[i], times[i] / (double)sizes[i]);
+        if (bytes[i] > 0)
+        {
+            printf(" %12.4g", bytes[i] * 1E9 / times[i]);
+        }
+        else
+        {
+            printf(" %12s", "-");
+        }
+        if (items[i] > 0)
+        {
+            printf(" %12.4g\n", items[i] * 1E9 / times[i]);
+        }
+        else
+        {
+            printf(" %12s\n", "-");
+        }
+    }
+    if (count >= 3)
+    {
+        printf("    rms");
+        for (i = 0; i < __MT_COMPLEXITY_COUNT; i++)
+        {
+            printf("%s %s %.3f", i ? "," : "", __mt_complexity_names[i], rms[i]);
+        }
+        printf("\n");
+    }
+    (void)fflush(stdout);
+    __mt_trace_record("bench", name, trace_start);
+}
+
+/* 运行范围基准测试，不满足过滤或分片条件的基准测试会被跳过 */
+static __MT_UNUSED void __mt_run_range_benchcase(void (*benchcase)(size_t n), const char *name,
+                                                 size_t from, size_t to, int complexity, int flush)
+{
+    struct __mt_plan_item *item = NULL;
+
+    if (!__mt_testcase_selected(name))
+    {
+        return;
+    }
+    if (__mt_plan_collecting && NULL != (item = __mt_plan_append(4, NULL, NULL, name, 0, 0)))
+    {
+        item->range_benchcase = benchcase;
+        item->range_from = from;
+        item->range_to = to;
+        item->complexity = complexity;
+        item->flush = flush;
+        return;
+    }
+    __mt_run_selected_range_benchcase(benchcase, name, from, to, complexity, flush);
+}
+
+/* 浮点数比较失败时输出的有效数字位数，由MT_FLOAT_EPSILON在编译期推导（即1 - log10(MT_FLOAT_EPSILON)） */
+#ifndef MT_FLOAT_SIGNIFICANT_FIGURES
+#define MT_FLOAT_SIGNIFICANT_FIGURES \
+    (MT_FLOAT_EPSILON > 1E-1    ? 1  \
+     : MT_FLOAT_EPSILON > 1E-2  ? 2  \
+     : MT_FLOAT_EPSILON > 1E-3  ? 3  \
+     : MT_FLOAT_EPSILON > 1E-4  ? 4  \
+     : MT_FLOAT_EPSILON > 1E-5  ? 5  \
+     : MT_FLOAT_EPSILON > 1E-6  ? 6  \
+     : MT_FLOAT_EPSILON > 1E-7  ? 7  \
+     : MT_FLOAT_EPSILON > 1E-8  ? 8  \
+     : MT_FLOAT_EPSILON > 1E-9  ? 9  \
+     : MT_FLOAT_EPSILON > 1E-10 ? 10 \
+     : MT_FLOAT_EPSILON > 1E-11 ? 11 \
+     : MT_FLOAT_EPSILON > 1E-12 ? 12 \
+     : MT_FLOAT_EPSILON > 1E-13 ? 13 \
+     : MT_FLOAT_EPSILON > 1E-14 ? 14 \
+     : MT_FLOAT_EPSILON > 1E-15 ? 15 \
+     : MT_FLOAT_EPSILON > 1E-16 ? 16 \
+                                : 17)
+#endif
+
+/* 以下为各类断言失败时的消息生成函数，均为cold函数，避免格式化代码在每个断言调用处展开 */
+static __MT_COLD void __mt_fail_message(const char *file, int line, const char *message)
+{
+    __mt_fail(file, line, "%s", message);
+}
+static __MT_COLD void __mt_fail_not_null(const char *file, int line, const char *expression)
+{
+    __mt_fail(file, line, "%s should not be NULL", expression);
+}
+static __MT_COLD void __mt_fail_pointer_eq(const char *file, int line, void *expected, void *result)
+{
+    __mt_fail(file, line, "expected result: %p, actual result: %p", expected, result);
+}
+static __MT_COLD void __mt_fail_int_eq(const char *file, int line, int expected, int result)
+{
+    __mt_fail(file, line, "expected result: %d, actual result: %d", expected, result);
+}
+static __MT_COLD void __mt_fail_double_eq(const char *file, int line, double expected, double result)
+{
+    __mt_fail(file, line, "expected result: %.*g, actual result: %.*g",
+              MT_FLOAT_SIGNIFICANT_FIGURES, expected, MT_FLOAT_SIGNIFICANT_FIGURES, result);
+}
+static __MT_COLD void __mt_fail_string_eq(const char *file, int line, const char *expected, const char *result)
+{
+    __mt_fail(file, line, "expected result: \"%s\", actual result: \"%s\"", expected, result);
+}
+static __MT_COLD void __mt_fail_int_array_eq(const char *file, int line,
+                                             const int *expected, int expected_len,
+                                             const int *result, int result_len)
+{
+    int i = 0;
+    if (expected_len != result_len)
+    {
+        __mt_fail(file, line, "expected array length: %d, actual array length: %d", expected_len, result_len);
+        return;
+    }
+    while (i < expected_len - 1 && expected[i] == result[i])
+    {
+        i++;
+    }
+    __mt_fail(file, line, "expected array[%d]: %d, actual array[%d]: %d", i, expected[i], i, result[i]);
+}
+
+/* 以下各检查均提供mt_assert_*和mt_expect_*两种形式，由内部的__MT_CHECK_*宏以fatal参数区分： */
+/* mt_assert_*失败时结束当前测试用例；mt_expect_*失败时只记录失败并继续执行，用例中所有失败在用例结束时一并输出 */
+#define __MT_FAILED_1 return
+#define __MT_FAILED_0 (void)0
+
 /* 条件检查断言，在condition条件不为真时测试失败，结束当前测试用例并基于message信息生成提示消息 */
-#define mt_assert(condition, message)                              \
-    do                                                             \
-    {                                                              \
-        if (!(condition))                                          \
-        {                                                          \
-            (void)snprintf(__mt_message_cache, MT_MESSAGE_MAX_LEN, \
-                           "%s:%d: %s",                            \
-                           __FILE__, __LINE__, message);           \
-            __mt_testcase_run_status = 1;                          \
-            return;                                                \
-        }                                                          \
+#define __MT_CHECK(fatal, condition, message)               \
+    do                                                      \
+    {                                                       \
+        if (__MT_UNLIKELY(!(condition)))                    \
+        {                                                   \
+            __mt_failure_fatal = fatal;                     \
+            __mt_fail_message(__FILE__, __LINE__, message); \
+            __MT_FAILED_##fatal;                            \
+        }                                                   \
     } while (0)
+#define mt_assert(condition, message) __MT_CHECK(1, condition, message)
+#define mt_expect(condition, message) __MT_CHECK(0, condition, message)
 
 /* 指针判空断言，在pointer指针为NULL时测试失败，结束当前测试用例并生成固定格式的提示消息 */
-#define mt_assert_not_null(pointer)                                \
-    do                                                             \
-    {                                                              \
-        if (NULL == (pointer))                                     \
-        {                                                          \
-            (void)snprintf(__mt_message_cache, MT_MESSAGE_MAX_LEN, \
-                           "%s:%d: %s should not be NULL",         \
-                           __FILE__, __LINE__, #pointer);          \
-            __mt_testcase_run_status = 1;                          \
-            return;                                                \
-        }                                                          \
+#define __MT_CHECK_NOT_NULL(fatal, pointer)                   \
+    do                                                        \
+    {                                                         \
+        if (__MT_UNLIKELY(NULL == (pointer)))                 \
+        {                                                     \
+            __mt_failure_fatal = fatal;                       \
+            __mt_fail_not_null(__FILE__, __LINE__, #pointer); \
+            __MT_FAILED_##fatal;                              \
+        }                                                     \
     } while (0)
+#define mt_assert_not_null(pointer) __MT_CHECK_NOT_NULL(1, pointer)
+#define mt_expect_not_null(pointer) __MT_CHECK_NOT_NULL(0, pointer)
 
 /* 指针类型结果检查，期望结果与实际结果不相等时测试失败，结束当前测试用例并并生成固定格式的提示消息 */
-#define mt_assert_pointer_eq(expected, result)                              \
-    do                                                                      \
-    {                                                                       \
-        void *tmp_e = (expected);                                           \
-        void *tmp_r = (result);                                             \
-        if (tmp_e != tmp_r)                                                 \
-        {                                                                   \
-            (void)snprintf(__mt_message_cache, MT_MESSAGE_MAX_LEN,          \
-                           "%s:%d: expected result: %p, actual result: %p", \
-                           __FILE__, __LINE__, tmp_e, tmp_r);               \
-            __mt_testcase_run_status = 1;                                   \
-            return;                                                         \
-        }                                                                   \
+#define __MT_CHECK_POINTER_EQ(fatal, expected, result)                \
+    do                                                                \
+    {                                                                 \
+        void *__mt_e = (expected);                                    \
+        void *__mt_r = (result);                                      \
+        if (__MT_UNLIKELY(__mt_e != __mt_r))                          \
+        {                                                             \
+            __mt_failure_fatal = fatal;                               \
+            __mt_fail_pointer_eq(__FILE__, __LINE__, __mt_e, __mt_r); \
+            __MT_FAILED_##fatal;                                      \
+        }                                                             \
     } while (0)
+#define mt_assert_pointer_eq(expected, result) __MT_CHECK_POINTER_EQ(1, expected, result)
+#define mt_expect_pointer_eq(expected, result) __MT_CHECK_POINTER_EQ(0, expected, result)
 
 /* 整数类型结果检查，期望结果与实际结果不相等时测试失败，结束当前测试用例并并生成固定格式的提示消息 */
-#define mt_assert_int_eq(expected, result)                                  \
-    do                                                                      \
-    {                                                                       \
-        int tmp_e = (expected);                                             \
-        int tmp_r = (result);                                               \
-        if (tmp_e != tmp_r)                                                 \
-        {                                                                   \
-            (void)snprintf(__mt_message_cache, MT_MESSAGE_MAX_LEN,          \
-                           "%s:%d: expected result: %d, actual result: %d", \
-                           __FILE__, __LINE__, tmp_e, tmp_r);               \
-            __mt_testcase_run_status = 1;                                   \
-            return;                                                         \
-        }                                                                   \
+#define __MT_CHECK_INT_EQ(fatal, expected, result)                \
+    do                                                            \
+    {                                                             \
+        int __mt_e = (expected);                                  \
+        int __mt_r = (result);                                    \
+        if (__MT_UNLIKELY(__mt_e != __mt_r))                      \
+        {                                                         \
+            __mt_failure_fatal = fatal;                           \
+            __mt_fail_int_eq(__FILE__, __LINE__, __mt_e, __mt_r); \
+            __MT_FAILED_##fatal;                                  \
+        }                                                         \
     } while (0)
+#define mt_assert_int_eq(expected, result) __MT_CHECK_INT_EQ(1, expected, result)
+#define mt_expect_int_eq(expected, result) __MT_CHECK_INT_EQ(0, expected, result)
 
 /* 浮点数类型结果检查，期望结果与实际结果的差值大于判定精度时测试失败 */
-#define mt_assert_double_eq(expected, result)                                       \
-    do                                                                              \
-    {                                                                               \
-        double tmp_e = (expected);                                                  \
-        double tmp_r = (result);                                                    \
-        int significant_figures = 1 - log10(MT_FLOAT_EPSILON);                      \
-        if (fabs(tmp_e - tmp_r) > MT_FLOAT_EPSILON)                                 \
-        {                                                                           \
-            (void)snprintf(__mt_message_cache, MT_MESSAGE_MAX_LEN,                  \
-                           "%s:%d: expected result: %.*g, actual result: %.*g",     \
-                           __FILE__, __LINE__,                                      \
-                           significant_figures, tmp_e, significant_figures, tmp_r); \
-            __mt_testcase_run_status = 1;                                           \
-            return;                                                                 \
-        }                                                                           \
+#define __MT_CHECK_DOUBLE_EQ(fatal, expected, result)                \
+    do                                                               \
+    {                                                                \
+        double __mt_e = (expected);                                  \
+        double __mt_r = (result);                                    \
+        if (__MT_UNLIKELY(fabs(__mt_e - __mt_r) > MT_FLOAT_EPSILON)) \
+        {                                                            \
+            __mt_failure_fatal = fatal;                              \
+            __mt_fail_double_eq(__FILE__, __LINE__, __mt_e, __mt_r); \
+            __MT_FAILED_##fatal;                                     \
+        }                                                            \
     } while (0)
+#define mt_assert_double_eq(expected, result) __MT_CHECK_DOUBLE_EQ(1, expected, result)
+#define mt_expect_double_eq(expected, result) __MT_CHECK_DOUBLE_EQ(0, expected, result)
 
 /* 字符串类型结果检查，期望结果与实际结果不相等时测试失败 */
-#define mt_assert_string_eq(expected, result)                                       \
-    do                                                                              \
-    {                                                                               \
-        const char *tmp_e = (expected) ? (expected) : "<null pointer>";             \
-        const char *tmp_r = (result) ? (result) : "<null pointer>";                 \
-        if (0 != strcmp(tmp_e, tmp_r))                                              \
-        {                                                                           \
-            (void)snprintf(__mt_message_cache, MT_MESSAGE_MAX_LEN,                  \
-                           "%s:%d: expected result: \"%s\", actual result: \"%s\"", \
-                           __FILE__, __LINE__, tmp_e, tmp_r);                       \
-            __mt_testcase_run_status = 1;                                           \
-            return;                                                                 \
-        }                                                                           \
+#define __MT_CHECK_STRING_EQ(fatal, expected, result)                \
+    do                                                               \
+    {                                                                \
+        const char *__mt_e = (expected);                             \
+        const char *__mt_r = (result);                               \
+        __mt_e = __mt_e ? __mt_e : "<null pointer>";                 \
+        __mt_r = __mt_r ? __mt_r : "<null pointer>";                 \
+        if (__MT_UNLIKELY(0 != strcmp(__mt_e, __mt_r)))              \
+        {                                                            \
+            __mt_failure_fatal = fatal;                              \
+            __mt_fail_string_eq(__FILE__, __LINE__, __mt_e, __mt_r); \
+            __MT_FAILED_##fatal;                                     \
+        }                                                            \
     } while (0)
+#define mt_assert_string_eq(expected, result) __MT_CHECK_STRING_EQ(1, expected, result)
+#define mt_expect_string_eq(expected, result) __MT_CHECK_STRING_EQ(0, expected, result)
 
 /* 整型数组结果检查，期望结果与实际结果的长度不相等或者对应元素不相等时测试失败 */
-#define mt_assert_int_array_eq(expected, expected_len, result, result_len)              \
-    do                                                                                  \
-    {                                                                                   \
-        int *tmp_e = (expected);                                                        \
-        int *tmp_r = (result);                                                          \
-        int tmp_e_len = (expected_len);                                                 \
-        int tmp_r_len = (result_len);                                                   \
-        int i = 0;                                                                      \
-        if (tmp_e_len != tmp_r_len)                                                     \
-        {                                                                               \
-            (void)snprintf(__mt_message_cache, MT_MESSAGE_MAX_LEN,                      \
-                           "%s:%d: expected array length: %d, actual array length: %d", \
-                           __FILE__, __LINE__, tmp_e_len, tmp_r_len);                   \
-            __mt_testcase_run_status = 1;                                               \
-            return;                                                                     \
-        }                                                                               \
-        for (i = 0; i < tmp_e_len; i++)                                                 \
-        {                                                                               \
-            if (tmp_e[i] != tmp_r[i])                                                   \
-            {                                                                           \
-                (void)snprintf(__mt_message_cache, MT_MESSAGE_MAX_LEN,                  \
-                               "%s:%d: expected array[%d]: %d, actual array[%d]: %d",   \
-                               __FILE__, __LINE__, i, tmp_e[i], i, tmp_r[i]);           \
-                __mt_testcase_run_status = 1;                                           \
-                return;                                                                 \
-            }                                                                           \
-        }                                                                               \
+#define __MT_CHECK_INT_ARRAY_EQ(fatal, expected, expected_len, result, result_len)              \
+    do                                                                                          \
+    {                                                                                           \
+        const int *__mt_e = (expected);                                                         \
+        const int *__mt_r = (result);                                                           \
+        int __mt_e_len = (expected_len);                                                        \
+        int __mt_r_len = (result_len);                                                          \
+        if (__MT_UNLIKELY(__mt_e_len != __mt_r_len ||                                           \
+                          (__mt_e_len > 0 &&                                                    \
+                           0 != memcmp(__mt_e, __mt_r, (size_t)__mt_e_len * sizeof(int)))))     \
+        {                                                                                       \
+            __mt_failure_fatal = fatal;                                                         \
+            __mt_fail_int_array_eq(__FILE__, __LINE__, __mt_e, __mt_e_len, __mt_r, __mt_r_len); \
+            __MT_FAILED_##fatal;                                                                \
+        }                                                                                       \
+    } while (0)
+#define mt_assert_int_array_eq(expected, expected_len, result, result_len) \
+    __MT_CHECK_INT_ARRAY_EQ(1, expected, expected_len, result, result_len)
+#define mt_expect_int_array_eq(expected, expected_len, result, result_len) \
+    __MT_CHECK_INT_ARRAY_EQ(0, expected, expected_len, result, result_len)
+
+/* 追加格式化内容到固定长度缓冲区，offset记录已写入长度，缓冲区写满后的内容被截断 */
+static __MT_UNUSED __MT_PRINTF(4, 5) void __mt_buffer_append(char *buffer, size_t size, size_t *offset,
+                                                             const char *format, ...)
+{
+    va_list args;
+    int written = 0;
+    if (*offset >= size)
+    {
+        return;
+    }
+    va_start(args, format);
+    written = vsnprintf(buffer + *offset, size - *offset, format, args);
+    va_end(args);
+    if (written > 0)
+    {
+        *offset += (size_t)written;
+    }
+}
+
+/* 内存块比较失败：统计不一致的字节总数，并以十六进制展示首个不一致位置前后的字节窗口 */
+static __MT_COLD void __mt_fail_mem_eq(const char *file, int line, const void *expected, const void *result, size_t size)
+{
+    const unsigned char *e = (const unsigned char *)expected;
+    const unsigned char *r = (const unsigned char *)result;
+    char window[MT_MESSAGE_MAX_LEN];
+    size_t offset = 0, first = size, diff_count = 0, begin = 0, end = 0, i = 0;
+    int pass = 0;
+
+    for (i = 0; i < size; i++)
+    {
+        if (e[i] != r[i])
+        {
+            first = first < size ? first : i;
+            diff_count++;
+        }
+    }
+    begin = first > MT_DIFF_WINDOW * 2 ? first - MT_DIFF_WINDOW * 2 : 0;
+    end = first + MT_DIFF_WINDOW * 2 + 1 < size ? first + MT_DIFF_WINDOW * 2 + 1 : size;
+    for (pass = 0; pass < 2; pass++)
+    {
+        const unsigned char *bytes = pass ? r : e;
+        __mt_buffer_append(window, sizeof(window), &offset, "\n      %s [0x%zx]:", pass ? "actual  " : "expected", begin);
+        for (i = begin; i < end; i++)
+        {
+            __mt_buffer_append(window, sizeof(window), &offset, i == first ? " [%02x]" : " %02x", bytes[i]);
+        }
+    }
+    __mt_fail(file, line, "%zu of %zu bytes differ, first mismatch at offset %zu%s",
+              diff_count, size, first, window);
+}
+
+/* 为各整数/浮点数类型生成批量数组比较函数：__mt_<type>_array_mismatch在容差范围外的首个元素位置， */
+/* 先按块无分支地检查是否存在不一致元素（便于编译器向量化），仅在块内存在不一致时再逐个定位 */
+#define __MT_ARRAY_BLOCK (64)
+#define __MT_INT_MISMATCH(e, r, tolerance) \
+    (((e) > (r) ? (uint64_t)(e) - (uint64_t)(r) : (uint64_t)(r) - (uint64_t)(e)) > (tolerance))
+#define __MT_FLOAT_MISMATCH(e, r, tolerance) \
+    (fabs((double)(e) - (double)(r)) > (tolerance) || isnan(e) != isnan(r))
+#define __MT_DEFINE_ARRAY_ASSERT(type_name, type, tolerance_type, mismatch, format, format_args)               \
+    static __MT_UNUSED size_t __mt_##type_name##_array_mismatch(const type *e, const type *r,                  \
+                                                                size_t count, tolerance_type tolerance)        \
+    {                                                                                                          \
+        size_t block = 0, i = 0, end = 0;                                                                      \
+        for (block = 0; block < count; block += __MT_ARRAY_BLOCK)                                              \
+        {                                                                                                      \
+            int bad = 0;                                                                                       \
+            end = block + __MT_ARRAY_BLOCK < count ? block + __MT_ARRAY_BLOCK : count;                         \
+            for (i = block; i < end; i++)                                                                      \
+            {                                                                                                  \
+                bad |= mismatch(e[i], r[i], tolerance);                                                        \
+            }                                                                                                  \
+            if (__MT_UNLIKELY(bad))                                                                            \
+            {                                                                                                  \
+                for (i = block; !mismatch(e[i], r[i], tolerance); i++)                                         \
+                {                                                                                              \
+                }                                                                                              \
+                return i;                                                                                      \
+            }                                                                                                  \
+        }                                                                                                      \
+        return count;                                                                                          \
+    }                                                                                                          \
+    static __MT_COLD void __mt_fail_##type_name##_array_eq(const char *file, int line,                         \
+                                                           const type *e, const type *r,                       \
+                                                           size_t count, tolerance_type tolerance)             \
+    {                                                                                                          \
+        char window[MT_MESSAGE_MAX_LEN];                                                                       \
+        size_t offset = 0, first = __mt_##type_name##_array_mismatch(e, r, count, tolerance);                  \
+        size_t diff_count = 0, begin = 0, end = 0, i = 0;                                                      \
+        int pass = 0;                                                                                          \
+        for (i = first; i < count; i++)                                                                        \
+        {                                                                                                      \
+            diff_count += mismatch(e[i], r[i], tolerance) ? 1 : 0;                                             \
+        }                                                                                                      \
+        begin = first > MT_DIFF_WINDOW ? first - MT_DIFF_WINDOW : 0;                                           \
+        end = first + MT_DIFF_WINDOW + 1 < count ? first + MT_DIFF_WINDOW + 1 : count;                         \
+        for (pass = 0; pass < 2; pass++)                                                                       \
+        {                                                                                                      \
+            const type *values = pass ? r : e;                                                                 \
+            __mt_buffer_append(window, sizeof(window), &offset, "\n      %s [%zu]:",                           \
+                               pass ? "actual  " : "expected", begin);                                         \
+            for (i = begin; i < end; i++)                                                                      \
+            {                                                                                                  \
+                __mt_buffer_append(window, sizeof(window), &offset, i == first ? " [" format "]" : " " format, \
+                                   format_args(values[i]));                                                    \
+            }                                                                                                  \
+        }                                                                                                      \
+        __mt_fail(file, line, "%zu of %zu " #type_name " elements differ (tolerance " format "), "             \
+                              "first mismatch at index %zu%s",                                                 \
+                  diff_count, count, format_args(tolerance), first, window);                                   \
+    }
+
+#define __MT_FORMAT_SIGNED(value) (long long)(value)
+#define __MT_FORMAT_UNSIGNED(value) (unsigned long long)(value)
+#define __MT_FORMAT_FLOAT(value) MT_FLOAT_SIGNIFICANT_FIGURES, (double)(value)
+__MT_DEFINE_ARRAY_ASSERT(int8, int8_t, uint64_t, __MT_INT_MISMATCH, "%lld", __MT_FORMAT_SIGNED)
+__MT_DEFINE_ARRAY_ASSERT(int16, int16_t, uint64_t, __MT_INT_MISMATCH, "%lld", __MT_FORMAT_SIGNED)
+__MT_DEFINE_ARRAY_ASSERT(int32, int32_t, uint64_t, __MT_INT_MISMATCH, "%lld", __MT_FORMAT_SIGNED)
+__MT_DEFINE_ARRAY_ASSERT(int64, int64_t, uint64_t, __MT_INT_MISMATCH, "%lld", __MT_FORMAT_SIGNED)
+__MT_DEFINE_ARRAY_ASSERT(uint8, uint8_t, uint64_t, __MT_INT_MISMATCH, "%llu", __MT_FORMAT_UNSIGNED)
+__MT_DEFINE_ARRAY_ASSERT(uint16, uint16_t, uint64_t, __MT_INT_MISMATCH, "%llu", __MT_FORMAT_UNSIGNED)
+__MT_DEFINE_ARRAY_ASSERT(uint32, uint32_t, uint64_t, __MT_INT_MISMATCH, "%llu", __MT_FORMAT_UNSIGNED)
+__MT_DEFINE_ARRAY_ASSERT(uint64, uint64_t, uint64_t, __MT_INT_MISMATCH, "%llu", __MT_FORMAT_UNSIGNED)
+__MT_DEFINE_ARRAY_ASSERT(float, float, double, __MT_FLOAT_MISMATCH, "%.*g", __MT_FORMAT_FLOAT)
+__MT_DEFINE_ARRAY_ASSERT(double, double, double, __MT_FLOAT_MISMATCH, "%.*g", __MT_FORMAT_FLOAT)
+
+/* 内存块比较断言，两段长度为size字节的内存内容不一致时测试失败，提示消息中给出不一致字节数及首个不一致位置附近的内容 */
+/* 比较基于memcmp实现，适用于校验大块输出缓冲区，失败时不会将整个缓冲区复制到提示消息中 */
+#define __MT_CHECK_MEM_EQ(fatal, expected, result, size)                     \
+    do                                                                       \
+    {                                                                        \
+        const void *__mt_e = (expected);                                     \
+        const void *__mt_r = (result);                                       \
+        size_t __mt_size = (size);                                           \
+        if (__MT_UNLIKELY(0 != memcmp(__mt_e, __mt_r, __mt_size)))           \
+        {                                                                    \
+            __mt_failure_fatal = fatal;                                      \
+            __mt_fail_mem_eq(__FILE__, __LINE__, __mt_e, __mt_r, __mt_size); \
+            __MT_FAILED_##fatal;                                             \
+        }                                                                    \
     } while (0)
+#define mt_assert_mem_eq(expected, result, size) __MT_CHECK_MEM_EQ(1, expected, result, size)
+#define mt_expect_mem_eq(expected, result, size) __MT_CHECK_MEM_EQ(0, expected, result, size)
+
+/* 定长类型数组批量比较的公共实现，先以memcmp快速判定完全相等，否则再逐元素按容差判定 */
+#define __MT_CHECK_ARRAY_EQ(fatal, type_name, type, expected, result, count, tolerance)                    \
+    do                                                                                                     \
+    {                                                                                                      \
+        const type *__mt_e = (expected);                                                                   \
+        const type *__mt_r = (result);                                                                     \
+        size_t __mt_count = (count);                                                                       \
+        if (__MT_UNLIKELY(0 != memcmp(__mt_e, __mt_r, __mt_count * sizeof(type))) &&                       \
+            __mt_##type_name##_array_mismatch(__mt_e, __mt_r, __mt_count, (tolerance)) < __mt_count)       \
+        {                                                                                                  \
+            __mt_failure_fatal = fatal;                                                                    \
+            __mt_fail_##type_name##_array_eq(__FILE__, __LINE__, __mt_e, __mt_r, __mt_count, (tolerance)); \
+            __MT_FAILED_##fatal;                                                                           \
+        }                                                                                                  \
+    } while (0)
+
+/* 定长整数类型数组批量比较断言，对应元素差值的绝对值大于tolerance时测试失败（tolerance为0即要求完全相等） */
+#define mt_assert_int8_array_eq(expected, result, count, tolerance) \
+    __MT_CHECK_ARRAY_EQ(1, int8, int8_t, expected, result, count, (uint64_t)(tolerance))
+#define mt_expect_int8_array_eq(expected, result, count, tolerance) \
+    __MT_CHECK_ARRAY_EQ(0, int8, int8_t, expected, result, count, (uint64_t)(tolerance))
+#define mt_assert_int16_array_eq(expected, result, count, tolerance) \
+    __MT_CHECK_ARRAY_EQ(1, int16, int16_t, expected, result, count, (uint64_t)(tolerance))
+#define mt_expect_int16_array_eq(expected, result, count, tolerance) \
+    __MT_CHECK_ARRAY_EQ(0, int16, int16_t, expected, result, count, (uint64_t)(tolerance))
+#define mt_assert_int32_array_eq(expected, result, count, tolerance) \
+    __MT_CHECK_ARRAY_EQ(1, int32, int32_t, expected, result, count, (uint64_t)(tolerance))
+#define mt_expect_int32_array_eq(expected, result, count, tolerance) \
+    __MT_CHECK_ARRAY_EQ(0, int32, int32_t, expected, result, count, (uint64_t)(tolerance))
+#define mt_assert_int64_array_eq(expected, result, count, tolerance) \
+    __MT_CHECK_ARRAY_EQ(1, int64, int64_t, expected, result, count, (uint64_t)(tolerance))
+#define mt_expect_int64_array_eq(expected, result, count, tolerance) \
+    __MT_CHECK_ARRAY_EQ(0, int64, int64_t, expected, result, count, (uint64_t)(tolerance))
+#define mt_assert_uint8_array_eq(expected, result, count, tolerance) \
+    __MT_CHECK_ARRAY_EQ(1, uint8, uint8_t, expected, result, count, (uint64_t)(tolerance))
+#define mt_expect_uint8_array_eq(expected, result, count, tolerance) \
+    __MT_CHECK_ARRAY_EQ(0, uint8, uint8_t, expected, result, count, (uint64_t)(tolerance))
+#define mt_assert_uint16_array_eq(expected, result, count, tolerance) \
+    __MT_CHECK_ARRAY_EQ(1, uint16, uint16_t, expected, result, count, (uint64_t)(tolerance))
+#define mt_expect_uint16_array_eq(expected, result, count, tolerance) \
+    __MT_CHECK_ARRAY_EQ(0, uint16, uint16_t, expected, result, count, (uint64_t)(tolerance))
+#define mt_assert_uint32_array_eq(expected, result, count, tolerance) \
+    __MT_CHECK_ARRAY_EQ(1, uint32, uint32_t, expected, result, count, (uint64_t)(tolerance))
+#define mt_expect_uint32_array_eq(expected, result, count, tolerance) \
+    __MT_CHECK_ARRAY_EQ(0, uint32, uint32_t, expected, result, count, (uint64_t)(tolerance))
+#define mt_assert_uint64_array_eq(expected, result, count, tolerance) \
+    __MT_CHECK_ARRAY_EQ(1, uint64, uint64_t, expected, result, count, (uint64_t)(tolerance))
+#define mt_expect_uint64_array_eq(expected, result, count, tolerance) \
+    __MT_CHECK_ARRAY_EQ(0, uint64, uint64_t, expected, result, count, (uint64_t)(tolerance))
+
+/* 浮点数类型数组批量比较断言，对应元素差值的绝对值大于tolerance时测试失败，两个NaN视为相等 */
+#define mt_assert_float_array_eq(expected, result, count, tolerance) \
+    __MT_CHECK_ARRAY_EQ(1, float, float, expected, result, count, (double)(tolerance))
+#define mt_expect_float_array_eq(expected, result, count, tolerance) \
+    __MT_CHECK_ARRAY_EQ(0, float, float, expected, result, count, (double)(tolerance))
+#define mt_assert_double_array_eq(expected, result, count, tolerance) \
+    __MT_CHECK_ARRAY_EQ(1, double, double, expected, result, count, (double)(tolerance))
+#define mt_expect_double_array_eq(expected, result, count, tolerance) \
+    __MT_CHECK_ARRAY_EQ(0, double, double, expected, result, count, (double)(tolerance))
+
+#ifdef MT_TRACK_ALLOCATIONS
+static __MT_COLD void __mt_fail_max_allocs(const char *file, int line, size_t limit, size_t count)
+{
+    __mt_fail(file, line, "expected at most %zu allocations, actual allocations: %zu", limit, count);
+}
+static __MT_COLD void __mt_fail_max_alloc_bytes(const char *file, int line, size_t limit, size_t bytes)
+{
+    __mt_fail(file, line, "expected at most %zu allocated bytes, actual allocated bytes: %zu", limit, bytes);
+}
+static __MT_COLD void __mt_fail_no_leaks(const char *file, int line, size_t blocks, size_t bytes)
+{
+    __mt_fail(file, line, "%zu blocks (%zu bytes) allocated in this test case are not freed", blocks, bytes);
+}
+
+/* 内存分配次数断言（需开启MT_TRACK_ALLOCATIONS），当前用例开始以来的分配次数超过limit时测试失败 */
+#define __MT_CHECK_MAX_ALLOCS(fatal, limit)                                               \
+    do                                                                                    \
+    {                                                                                     \
+        size_t __mt_limit = (limit);                                                      \
+        if (__MT_UNLIKELY(__mt_alloc_stats.count > __mt_limit))                           \
+        {                                                                                 \
+            __mt_failure_fatal = fatal;                                                   \
+            __mt_fail_max_allocs(__FILE__, __LINE__, __mt_limit, __mt_alloc_stats.count); \
+            __MT_FAILED_##fatal;                                                          \
+        }                                                                                 \
+    } while (0)
+#define mt_assert_max_allocs(limit) __MT_CHECK_MAX_ALLOCS(1, limit)
+#define mt_expect_max_allocs(limit) __MT_CHECK_MAX_ALLOCS(0, limit)
+
+/* 内存分配字节数断言（需开启MT_TRACK_ALLOCATIONS），当前用例开始以来累计分配的字节数超过limit时测试失败 */
+#define __MT_CHECK_MAX_ALLOC_BYTES(fatal, limit)                                               \
+    do                                                                                         \
+    {                                                                                          \
+        size_t __mt_limit = (limit);                                                           \
+        if (__MT_UNLIKELY(__mt_alloc_stats.bytes > __mt_limit))                                \
+        {                                                                                      \
+            __mt_failure_fatal = fatal;                                                        \
+            __mt_fail_max_alloc_bytes(__FILE__, __LINE__, __mt_limit, __mt_alloc_stats.bytes); \
+            __MT_FAILED_##fatal;                                                               \
+        }                                                                                      \
+    } while (0)
+#define mt_assert_max_alloc_bytes(limit) __MT_CHECK_MAX_ALLOC_BYTES(1, limit)
+#define mt_expect_max_alloc_bytes(limit) __MT_CHECK_MAX_ALLOC_BYTES(0, limit)
+
+/* 内存泄漏断言（需开启MT_TRACK_ALLOCATIONS），当前用例开始以来分配的内存存在未释放的内存块时测试失败 */
+#define __MT_CHECK_NO_LEAKS(fatal)                                               \
+    do                                                                           \
+    {                                                                            \
+        if (__MT_UNLIKELY(__mt_alloc_stats.live_blocks > 0))                     \
+        {                                                                        \
+            __mt_failure_fatal = fatal;                                          \
+            __mt_fail_no_leaks(__FILE__, __LINE__, __mt_alloc_stats.live_blocks, \
+                               __mt_alloc_stats.live_bytes);                     \
+            __MT_FAILED_##fatal;                                                 \
+        }                                                                        \
+    } while (0)
+#define mt_assert_no_leaks() __MT_CHECK_NO_LEAKS(1)
+#define mt_expect_no_leaks() __MT_CHECK_NO_LEAKS(0)
+#endif
+
+#if __MT_PERF
+/* 读取当前用例开始以来指定计数器的读数，硬件计数器不可用时返回0，即相关断言静默通过 */
+static __MT_UNUSED uint64_t __mt_perf_counter(int index)
+{
+    struct __mt_perf_counters counters;
+    __mt_perf_read(&counters);
+    if (1 != counters.kind)
+    {
+        __mt_perf_skipped++;
+        return 0;
+    }
+    return counters.values[index];
+}
+static __MT_COLD void __mt_fail_max_perf_counter(const char *file, int line, int index,
+                                                 uint64_t limit, uint64_t value)
+{
+    __mt_fail(file, line, "expected at most %llu %s, actual %s: %llu",
+              (unsigned long long)limit, __mt_perf_names[0][index],
+              __mt_perf_names[0][index], (unsigned long long)value);
+}
+
+/* 硬件性能计数器阈值断言的公共实现（需开启MT_PERF_COUNTERS），当前用例开始以来的计数超过limit时测试失败 */
+#define __MT_CHECK_MAX_PERF_COUNTER(fatal, index, limit)                                   \
+    do                                                                                     \
+    {                                                                                      \
+        uint64_t __mt_limit = (limit);                                                     \
+        uint64_t __mt_value = __mt_perf_counter(index);                                    \
+        if (__MT_UNLIKELY(__mt_value > __mt_limit))                                        \
+        {                                                                                  \
+            __mt_failure_fatal = fatal;                                                    \
+            __mt_fail_max_perf_counter(__FILE__, __LINE__, index, __mt_limit, __mt_value); \
+            __MT_FAILED_##fatal;                                                           \
+        }                                                                                  \
+    } while (0)
+
+/* 指令数、缓存未命中数、分支预测失败数阈值断言，硬件计数器不可用时不做检查，未检查的断言数会在用例结果 */
+/* 及MT_REPORT_COUNT的统计中输出 */
+#define mt_assert_max_instructions(limit) __MT_CHECK_MAX_PERF_COUNTER(1, 0, limit)
+#define mt_expect_max_instructions(limit) __MT_CHECK_MAX_PERF_COUNTER(0, 0, limit)
+#define mt_assert_max_cache_misses(limit) __MT_CHECK_MAX_PERF_COUNTER(1, 1, limit)
+#define mt_expect_max_cache_misses(limit) __MT_CHECK_MAX_PERF_COUNTER(0, 1, limit)
+#define mt_assert_max_branch_misses(limit) __MT_CHECK_MAX_PERF_COUNTER(1, 2, limit)
+#define mt_expect_max_branch_misses(limit) __MT_CHECK_MAX_PERF_COUNTER(0, 2, limit)
+#endif
+
+/* 依次运行所有未被任何测试套件引用的已注册用例，mt_main将其归入名为default的测试套件 */
+static __MT_UNUSED void __mt_testsuite_default(void)
+{
+    struct __mt_registry_entry *entry = NULL;
+    for (entry = __mt_testcase_registry; entry; entry = entry->next)
+    {
+        if (!entry->referenced)
+        {
+            __mt_run_testcase(entry, __mt_get_default_timeout_ms());
+        }
+    }
+}
+
+/* 通用的测试程序入口：按定义顺序运行所有已注册的测试套件，以及未被任何套件引用的已注册用例 */
+/* 支持的命令行参数：                                                                        */
+/*   --filter=PATTERN   按"套件名/用例名"通配符过滤用例，多个规则以':'分隔，'-'开头表示排除     */
+/*   --list             仅列举将要运行的用例，不实际运行                                       */
+/*   --jobs=N           并行运行用例的worker进程数，等同于环境变量MT_JOBS                      */
+/*   --shard-index=I    当前分片序号，等同于环境变量MT_SHARD_INDEX                             */
+/*   --shard-total=N    分片总数，等同于环境变量MT_SHARD_TOTAL                                 */
+/*   --cache=FILE       结果缓存文件，上次失败的套件和用例优先运行，等同于环境变量MT_CACHE      */
+/*   --rerun-failed     仅运行缓存中上次失败的用例，需同时指定结果缓存                         */
+/*   --fail-fast        出现第一个失败用例后跳过剩余用例，等同于环境变量MT_FAIL_FAST=1          */
+/*   --fuzz-corpus=DIR  模糊测试语料库目录，等同于环境变量MT_FUZZ_CORPUS                       */
+/*   --fuzz-replay=FILE 模糊测试用例只以该文件内容执行一次，等同于环境变量MT_FUZZ_REPLAY        */
+/* 返回值可直接作为main函数的返回值使用，即失败用例数，命令行参数错误时返回1 */
+static __MT_UNUSED int mt_main(int argc, char *argv[])
+{
+    struct __mt_registry_entry *entry = NULL;
+    int i = 0, pass = 0;
+
+    /* 先加载环境变量中的过滤和分片配置，命令行参数可覆盖其值 */
+    __mt_filter = getenv("MT_FILTER");
+    __mt_shard_total = getenv("MT_SHARD_TOTAL") ? atoi(getenv("MT_SHARD_TOTAL")) : 1;
+    __mt_shard_index = getenv("MT_SHARD_INDEX") ? atoi(getenv("MT_SHARD_INDEX")) : 0;
+    for (i = 1; i < argc; i++)
+    {
+        if (0 == strncmp(argv[i], "--filter=", 9))
+        {
+            __mt_filter = argv[i] + 9;
+        }
+        else if (0 == strcmp(argv[i], "--list"))
+        {
+            __mt_list_only = 1;
+        }
+        else if (0 == strncmp(argv[i], "--jobs=", 7))
+        {
+            MT_CONFIGURE_JOBS(atoi(argv[i] + 7));
+        }
+        else if (0 == strncmp(argv[i], "--shard-index=", 14))
+        {
+            __mt_shard_index = atoi(argv[i] + 14);
+        }
+        else if (0 == strncmp(argv[i], "--shard-total=", 14))
+        {
+            __mt_shard_total = atoi(argv[i] + 14);
+        }
+        else if (0 == strncmp(argv[i], "--save-baseline=", 16))
+        {
+            __mt_baseline_save_path = argv[i] + 16;
+        }
+        else if (0 == strncmp(argv[i], "--compare-baseline=", 19))
+        {
+            __mt_baseline_compare_path = argv[i] + 19;
+        }
+        else if (0 == strncmp(argv[i], "--trace=", 8))
+        {
+            __mt_trace_path = argv[i] + 8;
+        }
+        else if (0 == strncmp(argv[i], "--cache=", 8))
+        {
+            __mt_cache_path = argv[i] + 8;
+        }
+        else if (0 == strcmp(argv[i], "--rerun-failed"))
+        {
+            __mt_rerun_failed = 1;
+        }
+        else if (0 == strcmp(argv[i], "--fail-fast"))
+        {
+            __mt_fail_fast = 1;
+        }
+#if __MT_HAS_POSIX
+        else if (0 == strncmp(argv[i], "--fuzz-corpus=", 14))
+        {
+            __mt_fuzz_corpus_dir = argv[i] + 14;
+        }
+        else if (0 == strncmp(argv[i], "--fuzz-replay=", 14))
+        {
+            __mt_fuzz_replay_path = argv[i] + 14;
+        }
+#endif
+        else if (0 == strncmp(argv[i], "--report=", 9))
+        {
+            if (0 != __mt_report_open(argv[i] + 9))
+            {
+                return 1;
+            }
+        }
+        else
+        {
+            fprintf(stderr, "usage: %s [--filter=PATTERN] [--list] [--jobs=N] "
+                            "[--shard-index=I --shard-total=N] "
+                            "[--save-baseline=FILE] [--compare-baseline=FILE] "
+                            "[--report=tap|junit|jsonl:FILE] [--trace=FILE] "
+                            "[--cache=FILE [--rerun-failed]] [--fail-fast] "
+                            "[--fuzz-corpus=DIR] [--fuzz-replay=FILE]\n",
+                    argv[0]);
+            return 1;
+        }
+    }
+    if (__mt_shard_total < 1 || __mt_shard_index < 0 || __mt_shard_index >= __mt_shard_total)
+    {
+        fprintf(stderr, "invalid shard configuration: index %d, total %d\n", __mt_shard_index, __mt_shard_total);
+        return 1;
+    }
+    if (__mt_rerun_failed > 0 && !__mt_cache_enabled())
+    {
+        fprintf(stderr, "--rerun-failed requires a result cache (--cache=FILE or MT_CACHE)\n");
+        return 1;
+    }
+
+    /* 开启结果缓存时分两轮运行：第一轮只运行上次存在失败用例的测试套件，第二轮运行其余套件 */
+    for (pass = __mt_cache_enabled() && !__mt_list_only ? 0 : 1; pass < 2; pass++)
+    {
+        for (entry = __mt_testsuite_registry; entry; entry = entry->next)
+        {
+            if (pass == (__mt_cache_enabled() && !__mt_list_only && __mt_cache_testsuite_failed(entry->name) ? 0 : 1))
+            {
+                __mt_run_testsuite(entry->function, entry->name);
+            }
+        }
+    }
+    __mt_run_testsuite(&__mt_testsuite_default, "default");
+    if (__mt_list_only)
+    {
+        return 0;
+    }
+    MT_REPORT_COUNT();
+    return MT_EXIT_CODE;
+}
+
+/* 开启内存分配跟踪且未使用链接期包装时，替换当前编译单元中后续的内存分配函数调用 */
+#if defined(MT_TRACK_ALLOCATIONS) && !defined(MT_TRACK_ALLOCATIONS_WRAP)
+#define malloc(size) __mt_malloc(size)
+#define calloc(count, size) __mt_calloc(count, size)
+#define realloc(pointer, size) __mt_realloc(pointer, size)
+#define free(pointer) __mt_free(pointer)
+#endif
 
 #endif /* __MINTEST_H__ */
@@ -0,0 +1,226 @@
+#include "mintest.h"
+
+#define BENCH_BUFFER_LEN (4096)
+
+static int *bench_buffer = NULL;
+static int *bench_expected = NULL;
+static int *bench_shifted = NULL;
+
+/* 基准测试准备函数，分配并初始化被测函数使用的数据缓冲区及其期望值副本，在每个基准测试开始前执行一次 */
+void bench_setup(void)
+{
+    int i = 0;
+    bench_buffer = (int *)malloc(BENCH_BUFFER_LEN * sizeof(int));
+    bench_expected = (int *)malloc(BENCH_BUFFER_LEN * sizeof(int));
+    bench_shifted = (int *)malloc(BENCH_BUFFER_LEN * sizeof(int));
+    for (i = 0; i < BENCH_BUFFER_LEN; i++)
+    {
+        bench_buffer[i] = i;
+        bench_expected[i] = i;
+        bench_shifted[i] = i + (i & 1);
+    }
+}
+/* 基准测试清理函数，释放数据缓冲区 */
+void bench_teardown(void)
+{
+    free(bench_buffer);
+    free(bench_expected);
+    free(bench_shifted);
+    bench_buffer = NULL;
+    bench_expected = NULL;
+    bench_shifted = NULL;
+}
+
+/* 待测试函数，计算int型数组所有元素的和 */
+long my_sum_int(const int *array, int len)
+{
+    long sum = 0;
+    int i = 0;
+    for (i = 0; i < len; i++)
+    {
+        sum += array[i];
+    }
+    return sum;
+}
+
+/* 定义基准测试bench_sum_int，测量my_sum_int处理整个缓冲区的耗时 */
+MT_BENCHCASE(bench_sum_int)
+{
+    /* 使用mt_do_not_optimize避免计算结果未被使用时整个调用被编译器优化掉 */
+    mt_do_not_optimize(my_sum_int(bench_buffer, BENCH_BUFFER_LEN));
+}
+
+/* 定义基准测试bench_memset，测量清零整个缓冲区的耗时 */
+MT_BENCHCASE(bench_memset)
+{
+    memset(bench_buffer, 0, BENCH_BUFFER_LEN * sizeof(int));
+    /* 缓冲区内容之后不再被读取，使用mt_clobber_memory避免写入操作被优化掉 */
+    mt_clobber_memory();
+}
+
+/* 定义基准测试bench_assert_int_eq，测量mt_assert_int_eq断言通过时的吞吐量（每秒断言次数） */
+MT_BENCHCASE(bench_assert_int_eq)
+{
+    int i = 0;
+    mt_bench_set_items_per_op(BENCH_BUFFER_LEN);
+    for (i = 0; i < BENCH_BUFFER_LEN; i++)
+    {
+        mt_assert_int_eq(i, bench_buffer[i]);
+    }
+}
+
+/* 定义基准测试bench_assert_double_eq，测量mt_assert_double_eq断言通过时的吞吐量 */
+MT_BENCHCASE(bench_assert_double_eq)
+{
+    int i = 0;
+    mt_bench_set_items_per_op(BENCH_BUFFER_LEN);
+    for (i = 0; i < BENCH_BUFFER_LEN; i++)
+    {
+        mt_assert_double_eq((double)i, (double)bench_buffer[i]);
+    }
+}
+
+/* 定义基准测试bench_assert_int_array_eq，测量mt_assert_int_array_eq比较整个缓冲区的吞吐量（每秒比较元素数） */
+MT_BENCHCASE(bench_assert_int_array_eq)
+{
+    mt_bench_set_items_per_op(BENCH_BUFFER_LEN);
+    mt_assert_int_array_eq(bench_expected, BENCH_BUFFER_LEN, bench_buffer, BENCH_BUFFER_LEN);
+}
+
+/* 定义基准测试bench_assert_int32_array_eq_tolerance，测量带容差的批量数组比较断言的吞吐量 */
+/* 第一次比较完全相等，由memcmp快速判定通过；第二次奇数位置的元素相差1，会走逐元素按容差比较的路径 */
+MT_BENCHCASE(bench_assert_int32_array_eq_tolerance)
+{
+    mt_bench_set_items_per_op(BENCH_BUFFER_LEN);
+    mt_assert_int32_array_eq(bench_expected, bench_buffer, BENCH_BUFFER_LEN, 0);
+    mt_assert_int32_array_eq(bench_expected, bench_shifted, BENCH_BUFFER_LEN, 1);
+}
+
+#define RANGE_BUFFER_LEN (1 << 22)
+
+static int *range_source = NULL;
+static int *range_buffer = NULL;
+
+/* 范围基准测试准备函数，按最大数据规模分配缓冲区并填充伪随机数据，各规模只使用缓冲区的前n个元素 */
+void range_setup(void)
+{
+    unsigned int seed = 1;
+    int i = 0;
+    range_source = (int *)malloc(RANGE_BUFFER_LEN * sizeof(int));
+    range_buffer = (int *)malloc(RANGE_BUFFER_LEN * sizeof(int));
+    for (i = 0; i < RANGE_BUFFER_LEN; i++)
+    {
+        seed = seed * 1103515245 + 12345;
+        range_source[i] = (int)(seed >> 8);
+        range_buffer[i] = range_source[i];
+    }
+}
+/* 范围基准测试清理函数，释放缓冲区 */
+void range_teardown(void)
+{
+    free(range_source);
+    free(range_buffer);
+    range_source = NULL;
+    range_buffer = NULL;
+}
+
+/* qsort使用的int比较函数 */
+static int compare_int(const void *a, const void *b)
+{
+    int x = *(const int *)a, y = *(const int *)b;
+    return (x > y) - (x < y);
+}
+
+/* 定义范围基准测试bench_sum_int_range，测量my_sum_int处理n个元素的耗时，同时输出每秒处理的字节数 */
+MT_BENCHCASE_RANGE(bench_sum_int_range, n)
+{
+    mt_bench_set_bytes_per_op(n * sizeof(int));
+    mt_bench_set_items_per_op(n);
+    mt_do_not_optimize(my_sum_int(range_buffer, (int)n));
+}
+
+/* 定义范围基准测试bench_qsort_range，测量复制并排序n个伪随机数的耗时 */
+MT_BENCHCASE_RANGE(bench_qsort_range, n)
+{
+    mt_bench_set_items_per_op(n);
+    memcpy(range_buffer, range_source, n * sizeof(int));
+    qsort(range_buffer, n, sizeof(int), compare_int);
+    mt_clobber_memory();
+}
+
+/* 定义范围基准测试bench_count_inversions_range，逐对比较n个元素统计逆序对数，耗时随n平方增长 */
+MT_BENCHCASE_RANGE(bench_count_inversions_range, n)
+{
+    long inversions = 0;
+    size_t i = 0, j = 0;
+    for (i = 0; i < n; i++)
+    {
+        for (j = i + 1; j < n; j++)
+        {
+            inversions += range_source[i] > range_source[j];
+        }
+    }
+    mt_do_not_optimize(inversions);
+}
+
+/* 组合上述基准测试定义测试套件bench_suite1，基准测试与测试用例共用setup和teardown配置 */
+MT_TESTSUITE(bench_suite1)
+{
+    MT_TESTSUITE_CONFIGURE(&bench_setup, &bench_teardown);
+
+    MT_RUN_BENCHCASE(bench_sum_int);
+    MT_RUN_BENCHCASE(bench_memset);
+}
+
+/* 组合断言吞吐量相关基准测试定义测试套件bench_suite2，用于发现测试框架自身断言实现的性能回退 */
+MT_TESTSUITE(bench_suite2)
+{
+    MT_TESTSUITE_CONFIGURE(&bench_setup, &bench_teardown);
+
+    MT_RUN_BENCHCASE(bench_assert_int_eq);
+    MT_RUN_BENCHCASE(bench_assert_double_eq);
+    MT_RUN_BENCHCASE(bench_assert_int_array_eq);
+    MT_RUN_BENCHCASE(bench_assert_int32_array_eq_tolerance);
+}
+
+/* 组合范围基准测试定义测试套件bench_suite3，数据规模从1K开始翻倍，输出耗时随规模变化的曲线并校验声明的复杂度 */
+/* 冷缓存版本在每次调用前清除CPU缓存，可以与热缓存版本对比内存带宽对吞吐量的影响 */
+MT_TESTSUITE(bench_suite3)
+{
+    MT_TESTSUITE_CONFIGURE(&range_setup, &range_teardown);
+
+    MT_RUN_BENCHCASE_RANGE(bench_sum_int_range, 1 << 10, RANGE_BUFFER_LEN, MT_O_N);
+    MT_RUN_BENCHCASE_RANGE_COLD(bench_sum_int_range, 1 << 10, RANGE_BUFFER_LEN, MT_O_N);
+    MT_RUN_BENCHCASE_RANGE(bench_qsort_range, 1 << 10, 1 << 18, MT_O_N_LOG_N);
+    MT_RUN_BENCHCASE_RANGE(bench_count_inversions_range, 1 << 6, 1 << 12, MT_O_N_SQUARED);
+}
+
+#ifdef BENCH_MISDECLARED
+/* 以低于实际复杂度的声明运行上述范围基准测试，验证复杂度校验能发现与声明不符的实现，每个基准测试都预期失败 */
+MT_TESTSUITE(bench_suite4)
+{
+    MT_TESTSUITE_CONFIGURE(&range_setup, &range_teardown);
+
+    MT_RUN_BENCHCASE_RANGE(bench_sum_int_range, 1 << 10, RANGE_BUFFER_LEN, MT_O_1); /* FAIL */
+    MT_RUN_BENCHCASE_RANGE(bench_qsort_range, 1 << 10, 1 << 18, MT_O_N); /* FAIL */
+    MT_RUN_BENCHCASE_RANGE(bench_count_inversions_range, 1 << 6, 1 << 12, MT_O_N_LOG_N); /* FAIL */
+}
+#endif
+
+int main(int argc, char *argv[])
+{
+    /* 带命令行参数运行时交给mt_main，支持过滤基准测试以及保存、比较性能基线 */
+    if (argc > 1)
+    {
+        return mt_main(argc, argv);
+    }
+
+    MT_RUN_TESTSUITE(bench_suite1); /* 运行基准测试套件bench_suite1 */
+    MT_RUN_TESTSUITE(bench_suite2); /* 运行基准测试套件bench_suite2 */
+    MT_RUN_TESTSUITE(bench_suite3); /* 运行范围基准测试套件bench_suite3 */
+#ifdef BENCH_MISDECLARED
+    MT_RUN_TESTSUITE(bench_suite4); /* 运行复杂度声明有误的范围基准测试套件bench_suite4 */
+#endif
+    MT_REPORT_COUNT();              /* 打印基准测试结果的计数统计 */
+    return MT_EXIT_CODE;
+}
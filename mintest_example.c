@@ -1,3 +1,5 @@
+/* 示例中生成临时黄金数据文件的mkstemp属于POSIX接口，需在引用任何头文件之前声明所需的POSIX版本 */
+#define _POSIX_C_SOURCE 200809L
 #include "mintest.h"
 
 static int test_int_value = 0;
@@ -94,6 +96,18 @@ MT_TESTCASE(test_assert_string_eq_fail)
     mt_assert_string_eq("hello world", test_string);   /* FAIL */
 }
 
+/* 另一个测试准备函数，重置test_int_value值为10 */
+void test_setup_ten(void)
+{
+    test_int_value = 10;
+}
+
+/* 定义测试用例test_reconfigure_pass，验证测试套件中途更换的准备函数只对此后运行的用例生效 */
+MT_TESTCASE(test_reconfigure_pass)
+{
+    mt_assert_int_eq(12, my_add_int(1, 1));
+}
+
 /* 组合上述一系列测试用例，定义基础测试套件test_suite1 */
 MT_TESTSUITE(test_suite1)
 {
@@ -109,11 +123,18 @@ MT_TESTSUITE(test_suite1)
     MT_RUN_TESTCASE(test_assert_double_eq_fail);
     MT_RUN_TESTCASE(test_assert_string_eq_pass);
     MT_RUN_TESTCASE(test_assert_string_eq_fail);
+
+    /* 更换准备函数后运行的用例使用新的配置，开启结果缓存后用例的执行顺序可能改变，但配置仍按运行用例时的值生效 */
+    MT_TESTSUITE_CONFIGURE(&test_setup_ten, &test_teardown);
+    MT_RUN_TESTCASE(test_reconfigure_pass);
 }
 
 /* 不配置用例准备和清理函数，组合部分测试用例定义测试套件test_suite2 */
 MT_TESTSUITE(test_suite2)
 {
+    /* 用例之间依赖执行顺序和共享状态，声明为串行套件，开启并行模式时也在当前进程内依次执行 */
+    MT_TESTSUITE_SERIAL();
+
     /* 在测试开始前手动初始化一次test_int_value值为1 */
     test_int_value = 1;
 
@@ -198,12 +219,510 @@ MT_TESTSUITE(test_suite4)
     MT_RUN_TESTCASE(test_assert_pointer_eq_fail);
 }
 
-int main(void)
+/* 定义测试用例test_timeout_pass，验证用例在超时时间内完成时测试成功的场景 */
+MT_TESTCASE(test_timeout_pass)
+{
+    mt_assert_int_eq(3, my_add_int(1, 1));
+}
+
+/* 定义测试用例test_timeout_fail，验证用例执行超时被中断并判定测试失败的场景 */
+MT_TESTCASE(test_timeout_fail)
+{
+    volatile int spin = 1;
+    while (spin) /* 死循环，直到超时被中断 */
+    {
+    }
+}
+
+/* 组合上述一系列测试用例，定义测试套件test_suite5，验证用例超时相关接口使用 */
+MT_TESTSUITE(test_suite5)
+{
+    MT_TESTSUITE_CONFIGURE(&test_setup, &test_teardown);
+
+    MT_RUN_TESTCASE_TIMEOUT(test_timeout_pass, 1000);
+    MT_RUN_TESTCASE_TIMEOUT(test_timeout_fail, 100); /* FAIL */
+}
+
+/* 定义测试用例test_assert_mem_eq_pass，验证mt_assert_mem_eq断言测试成功的场景 */
+MT_TESTCASE(test_assert_mem_eq_pass)
+{
+    char a[] = "a test buffer";
+    char b[] = "a test buffer";
+    mt_assert_mem_eq(a, b, sizeof(a));
+}
+
+/* 定义测试用例test_assert_mem_eq_fail，验证mt_assert_mem_eq断言内存内容不一致时测试失败的场景 */
+MT_TESTCASE(test_assert_mem_eq_fail)
+{
+    char a[] = "a test buffer";
+    char b[] = "a best buffed";
+    mt_assert_mem_eq(a, b, sizeof(a)); /* FAIL */
+}
+
+/* 定义测试用例test_assert_typed_array_eq_pass，验证定长类型数组在容差范围内比较测试成功的场景 */
+MT_TESTCASE(test_assert_typed_array_eq_pass)
+{
+    int16_t a[] = {100, -200, 300, -400};
+    int16_t b[] = {101, -200, 299, -400};
+    double c[] = {0.1, 0.2, 0.3};
+    double d[] = {0.1, 0.2, 0.1 + 0.2};
+    mt_assert_int16_array_eq(a, b, 4, 1);
+    mt_assert_double_array_eq(c, d, 3, MT_FLOAT_EPSILON);
+}
+
+/* 定义测试用例test_assert_typed_array_eq_fail，验证定长类型数组元素超出容差时测试失败的场景 */
+MT_TESTCASE(test_assert_typed_array_eq_fail)
+{
+    int32_t a[] = {1, 2, 3, 4, 5, 6, 7, 8};
+    int32_t b[] = {1, 2, 3, 9, 5, 6, 0, 8};
+    mt_assert_int32_array_eq(a, b, 8, 0); /* FAIL */
+}
+
+/* 组合上述一系列测试用例，定义测试套件test_suite6，验证批量内存/数组比较相关断言接口使用 */
+MT_TESTSUITE(test_suite6)
+{
+    MT_RUN_TESTCASE(test_assert_mem_eq_pass);
+    MT_RUN_TESTCASE(test_assert_mem_eq_fail);
+    MT_RUN_TESTCASE(test_assert_typed_array_eq_pass);
+    MT_RUN_TESTCASE(test_assert_typed_array_eq_fail);
+}
+
+#ifdef MT_TRACK_ALLOCATIONS
+/* 定义测试用例test_assert_allocs_pass，验证内存分配次数在预算内且无泄漏时测试成功的场景 */
+MT_TESTCASE(test_assert_allocs_pass)
+{
+    int *p = (int *)malloc(sizeof(int));
+    free(p);
+    mt_assert_max_allocs(1);
+    mt_assert_no_leaks();
+}
+
+/* 定义测试用例test_assert_allocs_fail，验证内存分配次数超出预算时测试失败的场景 */
+MT_TESTCASE(test_assert_allocs_fail)
+{
+    int *p = (int *)calloc(4, sizeof(int));
+    p = (int *)realloc(p, 8 * sizeof(int));
+    free(p);
+    mt_assert_max_allocs(1); /* FAIL */
+}
+
+/* 定义测试用例test_realloc_zero_pass，验证realloc(p, 0)释放原内存块并返回NULL（如glibc）时不会被误判为泄漏 */
+MT_TESTCASE(test_realloc_zero_pass)
+{
+    int *p = (int *)malloc(sizeof(int));
+    p = (int *)realloc(p, 0);
+    free(p);
+    mt_assert_no_leaks();
+}
+
+/* 定义测试用例test_assert_no_leaks_fail，验证用例存在未释放的内存时测试失败的场景 */
+MT_TESTCASE(test_assert_no_leaks_fail)
+{
+    static int *leaked = NULL;
+    leaked = (int *)malloc(sizeof(int));
+    mt_assert_not_null(leaked);
+    mt_assert_no_leaks(); /* FAIL */
+}
+
+/* 组合上述一系列测试用例，定义测试套件test_suite7，验证内存分配跟踪相关断言接口使用 */
+/* 仅在引用mintest.h前定义了MT_TRACK_ALLOCATIONS时可用 */
+MT_TESTSUITE(test_suite7)
+{
+    MT_RUN_TESTCASE(test_assert_allocs_pass);
+    MT_RUN_TESTCASE(test_assert_allocs_fail);
+    MT_RUN_TESTCASE(test_realloc_zero_pass);
+    MT_RUN_TESTCASE(test_assert_no_leaks_fail);
+}
+#endif
+
+#ifdef MT_PERF_COUNTERS
+/* 定义测试用例test_assert_max_instructions_pass，验证硬件性能计数器阈值断言测试成功的场景 */
+/* 硬件计数器不可用（如权限受限或运行在虚拟机中）时断言不做检查，用例结果中显示软件事件计数 */
+MT_TESTCASE(test_assert_max_instructions_pass)
+{
+    mt_assert_int_eq(3, my_add_int(1, 1));
+    mt_assert_max_instructions(100000);
+    mt_assert_max_branch_misses(1000);
+}
+
+/* 组合上述测试用例，定义测试套件test_suite8，验证性能计数器相关断言接口使用 */
+/* 仅在引用mintest.h前定义了MT_PERF_COUNTERS时可用 */
+MT_TESTSUITE(test_suite8)
+{
+    MT_TESTSUITE_CONFIGURE(&test_setup, &test_teardown);
+
+    MT_RUN_TESTCASE(test_assert_max_instructions_pass);
+}
+#endif
+
+/* 并发用例共享的计数器，由各线程通过原子操作递增 */
+static volatile long concurrent_counter = 0;
+
+static void concurrent_setup(void)
+{
+    concurrent_counter = 0;
+}
+
+/* 定义测试用例test_concurrent_pass，验证多个线程并发执行断言（含内存分配）均通过的场景 */
+MT_TESTCASE(test_concurrent_pass)
+{
+    long *p = (long *)malloc(sizeof(long));
+    mt_assert_not_null(p);
+    *p = __sync_add_and_fetch(&concurrent_counter, 1);
+    mt_assert(*p > 0, "concurrent counter should be positive");
+    free(p);
+}
+
+/* 定义测试用例test_concurrent_fail，验证并发执行时某个线程断言失败后整个用例失败的场景 */
+MT_TESTCASE(test_concurrent_fail)
+{
+    mt_assert(__sync_add_and_fetch(&concurrent_counter, 1) != 100, "concurrent counter reached 100"); /* FAIL */
+}
+
+/* 在用例自行创建的线程上执行的断言，断言失败时直接返回，因此需要写在返回void的函数中 */
+static void thread_check(void)
+{
+    mt_assert(test_string[0] == 'b', "assertion on a helper thread should fail this case"); /* FAIL */
+}
+static void *thread_main(void *arg)
 {
-    MT_RUN_TESTSUITE(test_suite1); /* 运行测试套件test_suite1 */
-    MT_RUN_TESTSUITE(test_suite2); /* 运行测试套件test_suite2 */
-    MT_RUN_TESTSUITE(test_suite3); /* 运行测试套件test_suite3 */
-    MT_RUN_TESTSUITE(test_suite4); /* 运行测试套件test_suite4 */
-    MT_REPORT_COUNT();             /* 打印所有用例测试结果的计数统计 */
+    (void)arg;
+    thread_check();
+    return NULL;
+}
+
+/* 定义测试用例test_thread_assert_fail，验证用例函数体中自行创建的线程上的断言失败会合并回该用例 */
+MT_TESTCASE(test_thread_assert_fail)
+{
+    pthread_t thread;
+    mt_assert(0 == pthread_create(&thread, NULL, thread_main, NULL), "failed to create the helper thread");
+    (void)pthread_join(thread, NULL);
+}
+
+/* 组合上述测试用例，定义测试套件test_suite9，验证并发压力测试接口的使用 */
+MT_TESTSUITE(test_suite9)
+{
+    MT_TESTSUITE_CONFIGURE(&concurrent_setup, NULL);
+
+    MT_RUN_CONCURRENT(test_concurrent_pass, 4, 1000);
+    MT_RUN_CONCURRENT(test_concurrent_fail, 4, 1000);
+    MT_RUN_TESTCASE(test_thread_assert_fail);
+}
+
+/* 套件级共享夹具，模拟创建成本较高的数据（如大型索引），setup_count记录夹具被创建的次数 */
+/* dirty用于验证每个用例开始前reset接口都会将用例对夹具的修改恢复 */
+struct test_fixture
+{
+    int setup_count;
+    int dirty;
+    int values[1024];
+};
+static int test_fixture_setup_count = 0;
+
+/* 共享夹具的创建函数，在套件中第一个被选中的用例运行前执行一次 */
+static void *test_fixture_setup_once(void)
+{
+    struct test_fixture *fixture = (struct test_fixture *)calloc(1, sizeof(struct test_fixture));
+    int i = 0;
+    if (fixture)
+    {
+        MT_TRACE_SCOPE("fill fixture values"); /* 开启追踪时该代码块的耗时会出现在追踪时间线中 */
+        for (i = 0; i < 1024; i++)
+        {
+            fixture->values[i] = i;
+        }
+        fixture->setup_count = ++test_fixture_setup_count;
+    }
+    return fixture;
+}
+/* 共享夹具的销毁函数，在套件结束时执行一次 */
+static void test_fixture_teardown_once(void *context)
+{
+    free(context);
+}
+/* 共享夹具的重置函数，在每个用例开始前执行，仅恢复被用例修改的状态 */
+static void test_fixture_reset(void *context)
+{
+    if (context)
+    {
+        ((struct test_fixture *)context)->dirty = 0;
+    }
+}
+
+/* 定义测试用例test_fixture_shared_pass，验证用例可以访问只创建一次的共享夹具 */
+MT_TESTCASE_F(test_fixture_shared_pass, struct test_fixture, fixture)
+{
+    mt_assert_not_null(fixture);
+    mt_assert_int_eq(1, fixture->setup_count);
+    mt_assert_int_eq(1023, fixture->values[1023]);
+    fixture->dirty = 1;
+}
+
+/* 定义测试用例test_fixture_reset_pass，验证上一个用例对共享夹具的修改已被reset接口恢复 */
+MT_TESTCASE_F(test_fixture_reset_pass, struct test_fixture, fixture)
+{
+    mt_assert_not_null(fixture);
+    mt_assert_int_eq(0, fixture->dirty);
+    mt_assert_int_eq(1, MT_FIXTURE(struct test_fixture)->setup_count);
+    fixture->dirty = 1;
+}
+
+/* 组合上述测试用例，定义测试套件test_suite10，验证套件级共享夹具接口的使用 */
+MT_TESTSUITE(test_suite10)
+{
+    MT_TESTSUITE_CONFIGURE_ONCE(&test_fixture_setup_once, &test_fixture_teardown_once);
+    MT_TESTSUITE_CONFIGURE_RESET(&test_fixture_reset);
+
+    MT_RUN_TESTCASE(test_fixture_shared_pass);
+    MT_RUN_TESTCASE(test_fixture_reset_pass);
+}
+
+/* 定义测试用例test_expect_pass，验证非致命检查全部通过时用例通过的场景 */
+MT_TESTCASE(test_expect_pass)
+{
+    int values[40];
+    int i = 0;
+    for (i = 0; i < 40; i++)
+    {
+        values[i] = i;
+    }
+    for (i = 0; i < 40; i++)
+    {
+        mt_expect_int_eq(i, values[i]);
+    }
+    mt_expect_string_eq("hello world", "hello world");
+    mt_expect_int32_array_eq(values, values, 40, 0);
+}
+
+/* 定义测试用例test_expect_fail，验证非致命检查失败后用例继续执行，所有失败在用例结束时一并输出， */
+/* 其后的致命断言失败同样被记录并结束用例 */
+MT_TESTCASE(test_expect_fail)
+{
+    int values[40];
+    int i = 0;
+    for (i = 0; i < 40; i++)
+    {
+        values[i] = i % 16 == 7 ? -i : i;
+    }
+    for (i = 0; i < 40; i++)
+    {
+        mt_expect_int_eq(i, values[i]); /* FAIL: i = 7, 23, 39 */
+    }
+    mt_expect_string_eq("hello world", "a test string");              /* FAIL */
+    mt_assert(values[7] == 7, "values[7] should be 7, stop this case"); /* FAIL */
+    mt_expect(0, "should not be reached after a failed assertion");
+}
+
+/* 组合上述测试用例，定义测试套件test_suite11，验证非致命检查接口的使用 */
+MT_TESTSUITE(test_suite11)
+{
+    MT_RUN_TESTCASE(test_expect_pass);
+    MT_RUN_TESTCASE(test_expect_fail);
+}
+
+/* 被模糊测试的解析函数：输入由若干条记录组成，每条记录以1字节的长度开头，返回记录数并通过payload返回各记录内容的 */
+/* 总长度，格式错误时返回-1；stop_at_0xff用于模拟将长度0xff误当作结束标记的解析缺陷 */
+static int parse_records(const uint8_t *data, size_t size, size_t *payload, int stop_at_0xff)
+{
+    size_t offset = 0;
+    int count = 0;
+    *payload = 0;
+    while (offset < size)
+    {
+        size_t length = data[offset];
+        if (stop_at_0xff && 0xff == length)
+        {
+            break;
+        }
+        if (length > size - offset - 1)
+        {
+            return -1;
+        }
+        *payload += length;
+        offset += length + 1;
+        count++;
+    }
+    return count;
+}
+
+/* 定义模糊测试用例fuzz_parse_records_pass，验证解析成功时所有记录恰好覆盖整个输入 */
+MT_FUZZCASE(fuzz_parse_records_pass, data, size)
+{
+    size_t payload = 0;
+    int count = parse_records(data, size, &payload, 0);
+    mt_assert(count < 0 || payload + (size_t)count == size, "records should cover the whole input");
+}
+
+/* 定义模糊测试用例fuzz_parse_records_fail，验证模糊测试能找到触发解析缺陷的输入并保存到文件 */
+MT_FUZZCASE(fuzz_parse_records_fail, data, size)
+{
+    size_t payload = 0;
+    int count = parse_records(data, size, &payload, 1);
+    mt_assert(count < 0 || payload + (size_t)count == size, "records should cover the whole input"); /* FAIL */
+}
+
+#ifdef MT_FUZZ_COVERAGE
+/* 定义模糊测试用例fuzz_magic_fail，输入以"FUZZ"开头时失败，只有在覆盖率反馈的引导下才能在短时间内找到该输入 */
+MT_FUZZCASE(fuzz_magic_fail, data, size)
+{
+    if (size >= 4 && 'F' == data[0])
+    {
+        if ('U' == data[1])
+        {
+            if ('Z' == data[2])
+            {
+                mt_assert('Z' != data[3], "found the magic FUZZ header"); /* FAIL */
+            }
+        }
+    }
+}
+#endif
+
+/* 组合上述测试用例，定义测试套件test_suite12，验证模糊测试接口的使用 */
+MT_TESTSUITE(test_suite12)
+{
+    MT_RUN_FUZZCASE(fuzz_parse_records_pass);
+    MT_RUN_FUZZCASE(fuzz_parse_records_fail);
+#ifdef MT_FUZZ_COVERAGE
+    MT_RUN_FUZZCASE(fuzz_magic_fail);
+#endif
+}
+
+/* 待测试函数，辗转相除法计算最大公约数；skip_zero用于模拟未处理除数为0的缺陷 */
+static int my_gcd(int a, int b, int skip_zero)
+{
+    int t = 0;
+    if (skip_zero && 0 == b)
+    {
+        return 0;
+    }
+    while (0 != b)
+    {
+        t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+/* 二进制黄金数据文件的记录格式，由test_suite13的共享夹具按穷举法计算后写入临时文件 */
+struct gcd_vector
+{
+    int32_t a;
+    int32_t b;
+    int32_t gcd;
+};
+
+/* 共享夹具准备函数：生成a、b取值均为0~63的所有组合的二进制黄金数据文件，返回文件路径作为夹具上下文 */
+/* mkstemp会改写传入的模板，因此每次都复制一份模板，保证多次执行时都能生成新的临时文件 */
+void *gcd_vectors_setup_once(void)
+{
+    static const char path_template[] = "/tmp/mintest_gcd_XXXXXX";
+    char *path = (char *)malloc(sizeof(path_template));
+    struct gcd_vector vector;
+    int fd = -1;
+    FILE *file = NULL;
+    int a = 0, b = 0;
+    if (NULL == path)
+    {
+        return NULL;
+    }
+    memcpy(path, path_template, sizeof(path_template));
+    fd = mkstemp(path);
+    file = fd >= 0 ? fdopen(fd, "wb") : NULL;
+    for (a = 0; file && a < 64; a++)
+    {
+        for (b = 0; b < 64; b++)
+        {
+            vector.a = a;
+            vector.b = b;
+            vector.gcd = a > b ? a : b;
+            while (a && b && (a % vector.gcd || b % vector.gcd))
+            {
+                vector.gcd--;
+            }
+            (void)fwrite(&vector, sizeof(vector), 1, file);
+        }
+    }
+    if (file)
+    {
+        (void)fclose(file);
+    }
+    return path;
+}
+/* 共享夹具清理函数，删除临时的黄金数据文件并释放路径 */
+void gcd_vectors_teardown_once(void *path)
+{
+    if (path)
+    {
+        (void)unlink((const char *)path);
+    }
+    free(path);
+}
+
+/* 定义数据驱动用例datacase_gcd_csv_pass，逐条验证CSV黄金数据文件中的每条记录 */
+MT_DATACASE_CSV(datacase_gcd_csv_pass, "testdata/gcd.csv", record)
+{
+    int a = (int)mt_data_field_long(record, 0);
+    int b = (int)mt_data_field_long(record, 1);
+    mt_assert_int_eq(mt_data_field_long(record, 2), my_gcd(a, b, 0));
+}
+
+/* 定义数据驱动用例datacase_gcd_csv_fail，验证失败消息中包含出错记录的序号和行号，且出错后不再执行后续记录 */
+MT_DATACASE_CSV(datacase_gcd_csv_fail, "testdata/gcd.csv", record)
+{
+    int a = (int)mt_data_field_long(record, 0);
+    int b = (int)mt_data_field_long(record, 1);
+    mt_assert_int_eq(mt_data_field_long(record, 2), my_gcd(a, b, 1)); /* FAIL: record 3 (line 5) */
+}
+
+/* 定义数据驱动用例datacase_gcd_binary_pass，按结构体直接访问映射的二进制记录 */
+MT_DATACASE_BINARY(datacase_gcd_binary_pass, MT_FIXTURE(const char), sizeof(struct gcd_vector), record)
+{
+    const struct gcd_vector *vector = mt_data_as(record, struct gcd_vector);
+    mt_assert_int_eq(vector->gcd, my_gcd(vector->a, vector->b, 0));
+}
+
+/* 组合上述测试用例，定义测试套件test_suite13，验证数据驱动用例接口的使用 */
+MT_TESTSUITE(test_suite13)
+{
+    MT_TESTSUITE_CONFIGURE_ONCE(&gcd_vectors_setup_once, &gcd_vectors_teardown_once);
+
+    MT_RUN_TESTCASE(datacase_gcd_csv_pass);
+    MT_RUN_TESTCASE(datacase_gcd_csv_fail);
+    MT_RUN_TESTCASE(datacase_gcd_binary_pass);
+}
+
+#ifdef MT_FUZZ_LIBFUZZER
+/* 以libFuzzer构建时（-DMT_FUZZ_LIBFUZZER -fsanitize=fuzzer）使用fuzz_parse_records_pass作为入口，由libFuzzer提供main函数 */
+MT_FUZZ_LIBFUZZER_ENTRY(fuzz_parse_records_pass)
+#else
+int main(int argc, char *argv[])
+{
+    /* 带命令行参数运行时交给mt_main按定义顺序自动运行所有已注册的测试套件，支持过滤、列举及分片 */
+    if (argc > 1)
+    {
+        return mt_main(argc, argv);
+    }
+
+    MT_RUN_TESTSUITE(test_suite1);  /* 运行测试套件test_suite1 */
+    MT_RUN_TESTSUITE(test_suite2);  /* 运行测试套件test_suite2 */
+    MT_RUN_TESTSUITE(test_suite3);  /* 运行测试套件test_suite3 */
+    MT_RUN_TESTSUITE(test_suite4);  /* 运行测试套件test_suite4 */
+    MT_RUN_TESTSUITE(test_suite5);  /* 运行测试套件test_suite5 */
+    MT_RUN_TESTSUITE(test_suite6);  /* 运行测试套件test_suite6 */
+    MT_RUN_TESTSUITE(test_suite9);  /* 运行测试套件test_suite9 */
+    MT_RUN_TESTSUITE(test_suite10); /* 运行测试套件test_suite10 */
+    MT_RUN_TESTSUITE(test_suite11); /* 运行测试套件test_suite11 */
+    MT_RUN_TESTSUITE(test_suite12); /* 运行测试套件test_suite12 */
+    MT_RUN_TESTSUITE(test_suite13); /* 运行测试套件test_suite13 */
+#ifdef MT_TRACK_ALLOCATIONS
+    MT_RUN_TESTSUITE(test_suite7);  /* 运行测试套件test_suite7 */
+#endif
+#ifdef MT_PERF_COUNTERS
+    MT_RUN_TESTSUITE(test_suite8);  /* 运行测试套件test_suite8 */
+#endif
+    MT_REPORT_COUNT();              /* 打印所有用例测试结果的计数统计 */
     return MT_EXIT_CODE;
 }
+#endif